@@ -2,59 +2,200 @@
 #include "HAL/dc_motor.h"
 #include "HAL/buzzer.h"
 #include "MCAL/uart.h"
-#include "MCAL/timer1.h"
-#include <util/delay.h>
 #include "MCAL/twi.h"
+#include "MCAL/internal_eeprom.h"
+#include "MCAL/adc.h"
+#include "SERVICE/protocol.h"
+#include "SERVICE/config_store.h"
+#include "SERVICE/audit_log.h"
+#include "SERVICE/user_table.h"
+#include "SERVICE/sw_timer.h"
+#include "SERVICE/scheduler.h"
+#include "SERVICE/power.h"
+#include "SERVICE/motion_profile.h"
+#include "SERVICE/door_position.h"
+#include "SERVICE/stall_detector.h"
+#include "SERVICE/sound.h"
 
-// Define constants for communication protocol
-#define IS_PASSWORD_SETTED 'Q'              // Indicates if password is already set
-#define SETTED 'W'                          // Indicates password is already set in EEPROM
-#define NOT_SETTED 'E'                      // Indicates password is not set in EEPROM yet
-#define GET_READY_FOR_PASSWORD 'R'          // Request for entering a password
-#define CORRECT_PASSWORD 'T'                // Indicates correct password
-#define NOT_CORRECT_PASSWORD 'Y'            // Indicates incorrect password
-#define OPEN_DOOR 'U'                       // Command to open the door
-#define ERROR_ACTION 'I'                    // Action taken when an error occurs
-#define GET_READY_FOR_PASSWORD_ONE 'O'      // Request for entering the first password for setup
-#define GET_READY_FOR_PASSWORD_TWO 'P'      // Request for entering the second password for setup
-#define IS_MATCHED 'A'                     // Indicates that two entered passwords matched
-#define MATCHED 'S'                        // Indicates that two entered passwords matched
-#define NOT_MATCHED 'D'                    // Indicates that two entered passwords did not match
-
-#define IS_PASSWORD_SET_FLAG_LOCATION 0xDD
-
-#define PASSWORD_SIZE 5
+#define FAILED_ATTEMPTS_ADDRESS 0x04 // Internal EEPROM, after the config store hot copy
 
-uint8 i_counter; // Variable for loop iterations
-volatile uint8 timer1_ticks = 0; // Volatile variable for Timer1 ticks
-
-// Configuration for Timer1
-Timer1_ConfigType Timer1_config = {
-		.initial_value = 0,
-		.compare_value = 31250,
-		.mode = COMPARE, // Compare mode
-		.prescaler = PRESCALER_256 // Prescaler value
+// Door cycle, the HMI reads its progress with GET_STATUS
+#define DOOR_ACCEL_TIME_MS 1000 // Motor speed ramp up
+#define DOOR_CRUISE_TIME_MS 10000 // Motor at DOOR_SPEED at most, the end stops or the encoder end it earlier
+#define DOOR_DECEL_TIME_MS 1500 // Motor speed ramp down
+#define DOOR_BRAKE_TIME_MS 200 // Motor shorted so the door does not coast
+#define DOOR_SPEED FULL_SPEED
+#define DOOR_HOLD_TIME_MS 3000 // Door kept open
+#define PASSWORD_TRIES 3 // Wrong passwords in a row before the lockout, the same as the HMI
+#define ALARM_TIME_MS 60000 // Buzzer and lockout after too many wrong passwords
+#define STORAGE_RETRY_MS 10 // The internal EEPROM write queue was full, about one write cycle
+
+// Events of the protocol task
+#define EVENT_UART_RX 0 // Bytes are waiting in the UART RX buffer
+
+// Events of the door task
+#define EVENT_DOOR_OPEN 0 // Start a door cycle
+#define EVENT_DOOR_STEP_OVER 1 // The door motor stopped or the holding time is over
+
+// Events of the alarm task
+#define EVENT_ALARM_START 0 // Start or restart the buzzer
+#define EVENT_ALARM_TIMER 1 // The alarm time is over
+
+// Events of the storage task
+#define EVENT_SAVE_ATTEMPTS 0 // Save the failed attempts in the internal EEPROM
+
+// Speed profile of the door motor, the same for unlocking and locking
+const Motion_ProfileType door_profile = {
+		.accel_ms = DOOR_ACCEL_TIME_MS,
+		.cruise_ms = DOOR_CRUISE_TIME_MS,
+		.decel_ms = DOOR_DECEL_TIME_MS,
+		.brake_ms = DOOR_BRAKE_TIME_MS,
+		.cruise_speed = DOOR_SPEED
 };
 
-void recievePassword(uint8 *password);
+uint8 i_counter; // Variable for loop iterations
+uint8 failed_attempts = 0; // Wrong passwords in a row, PASSWORD_TRIES at most while the lockout runs
+uint8 granted_attempts = 0; // Wrong passwords before the last correct one
+uint8 master_verified = 0; // The master password has been entered, it can be changed now
+uint8 password_buffer[PASSWORD_SIZE]; // Array to store password
+uint8 password_check_buffer[PASSWORD_SIZE]; // Second password of the setup
+
+uint8 protocol_task; // Scheduler task ids
+uint8 door_task;
+uint8 alarm_task;
+uint8 storage_task;
+volatile uint8 uart_event_pending = 0; // An EVENT_UART_RX is queued, the RX ISR does not post another one
+
+Protocol_DoorStateType door_state = DOOR_CLOSED;
+uint32 door_step_end; // Timestamp at which the current step of the door cycle ends
+volatile uint8 door_stalled = 0; // The motor current stopped the current door move
+uint8 alarm_active = 0; // The alarm pattern is playing
+SwTimer_Type door_timer; // Ends the holding step of the door cycle
+SwTimer_Type alarm_timer;
+SwTimer_Type storage_timer;
 
 /*
  * Description:
- * This function is used as a callback for Timer1.
- * It is called whenever Timer1 overflows or a compare match occurs.
- * It increments the volatile variable timer1_ticks.
+ * This function copies the password carried in the payload of a request frame.
+ * It returns 0 if the payload length does not match PASSWORD_SIZE.
  */
-void timer1TickIncrement(void);
+uint8 recievePassword(const Protocol_FrameType *frame, uint8 *password);
 
-void main(void){
-	uint8 password_buffer[PASSWORD_SIZE]; // Array to store password
-	uint8 password_check_buffer[PASSWORD_SIZE];
-	uint8 password_is_set_f;
-	uint8 passwords_are_matched_f;
-	uint8 check_is_set_temp;
-	uint8 uart_command;
-	uint8 password_temp_check;
+/*
+ * Description:
+ * This function serves the USER_ADD, USER_REMOVE and USER_ENABLE commands.
+ * The payload starts with the master password followed by the user id.
+ * It returns SUCCESS if the user table has been updated.
+ */
+uint8 userCommand(const Protocol_FrameType *frame);
+
+/*
+ * Description:
+ * This function counts a wrong password and logs it.
+ * The lockout starts with the PASSWORD_TRIES wrong password in a row.
+ */
+void wrongPassword(void);
+
+/*
+ * Description:
+ * This function starts the lockout: the alarm plays and the passwords are refused
+ * for ALARM_TIME_MS.
+ */
+void startLockout(void);
+
+/*
+ * Description:
+ * This function returns 1 while the lockout refuses the passwords.
+ * The end of the alarm ends it.
+ */
+uint8 isLockedOut(void);
+
+/*
+ * Description:
+ * This function checks the master password at the start of the payload of a command frame.
+ * A wrong one is counted and logged like in GET_READY_FOR_MASTER_PASSWORD, nothing is
+ * checked during the lockout. It returns 1 if the password is correct.
+ */
+uint8 checkCommandPassword(const Protocol_FrameType *frame);
+
+/*
+ * Description:
+ * Scheduler task reading the request frames when EVENT_UART_RX is posted.
+ * Every complete frame is served and replied to right away.
+ */
+void protocolTask(uint8 event);
+
+/*
+ * Description:
+ * This function serves one valid request frame and sends its reply.
+ * The door and the alarm are only started here, their tasks run them.
+ */
+void serveRequest(const Protocol_FrameType *frame);
+
+/*
+ * Description:
+ * Scheduler task running the door cycle: unlocking, holding and locking.
+ * The motor moves with door_profile until the door position ends it, its duration is only a ceiling.
+ * The end of the move or of door_timer moves to the next step.
+ */
+void doorTask(uint8 event);
 
+/*
+ * Description:
+ * Start a door move in direction towards target, with the position tracking and the
+ * current monitoring.
+ */
+void doorMove(DcMotor_State direction, DoorPosition_TargetType target);
+
+/*
+ * Description:
+ * Apply the motor stall settings of a SET_STALL frame after checking the master password.
+ * Returns SUCCESS, or ERROR when the frame is refused and nothing changed.
+ */
+uint8 stallCommand(const Protocol_FrameType *frame);
+
+/*
+ * Description:
+ * Called when a door move is over, logs a stall, or a fault when it ran to the ceiling of
+ * door_profile without reaching its end stop or its last encoder pulse, a switch or the
+ * encoder is broken.
+ */
+void doorCheckArrival(void);
+
+/*
+ * Description:
+ * Scheduler task playing the alarm pattern for ALARM_TIME_MS after EVENT_ALARM_START.
+ * The pattern runs from the tick ISR, the requests are still served meanwhile.
+ * The end of the alarm ends the lockout.
+ */
+void alarmTask(uint8 event);
+
+/*
+ * Description:
+ * Scheduler task saving the failed attempts in the internal EEPROM.
+ */
+void storageTask(uint8 event);
+
+/*
+ * Description:
+ * These functions are called from the UART RX, the tick and the ADC ISRs,
+ * they only post the event of their task. doorStallEvent also brakes at once.
+ */
+void uartRxEvent(void);
+void doorStepEvent(void);
+void doorStallEvent(void);
+void alarmTimerEvent(void);
+void storageTimerEvent(void);
+
+/*
+ * Description:
+ * Scheduler idle hook, sleeps until the next interrupt.
+ * Only IDLE keeps the UART receiver and the Timer1 tick running, the deeper modes would
+ * miss the HMI requests. The tick wakes the MCU every millisecond at most.
+ */
+void enterSleep(void);
+
+void main(void){
 	// UART Configuration
 	UART_ConfigType UART_config = {
 			.bit_data = EIGHT_BITS,
@@ -71,119 +212,419 @@ void main(void){
 	SREG |= 1 << 7;
 
 	UART_init(&UART_config);
+	Protocol_init();
 	TWI_init(&TWI_config);
 	DcMotor_Init();
 	Buzzer_init();
 
-	Timer1_setCallBack(timer1TickIncrement);
+	SwTimer_init(); // 1 ms system tick, the audit records are stamped with it
+	TWI_setTimeSource(SwTimer_getMs); // Before the first EEPROM access
 
-	EEPROM_readByte(IS_PASSWORD_SET_FLAG_LOCATION, &check_is_set_temp);
-	if(check_is_set_temp != 1){
-		EEPROM_writeByte(IS_PASSWORD_SET_FLAG_LOCATION,0);
-		_delay_ms(15);
+	// Hot state in the internal EEPROM, the lockout counter survives a reset
+	IEEPROM_init();
+	failed_attempts = IEEPROM_readByte(FAILED_ATTEMPTS_ADDRESS);
+	if(failed_attempts == 0xFF){
+		failed_attempts = 0; // Never written
+	}else if(failed_attempts > PASSWORD_TRIES){
+		failed_attempts = PASSWORD_TRIES;
 	}
 
-	while(1){
-		uart_command = UART_recieveByte();
-		switch(uart_command){
-		case IS_PASSWORD_SETTED:
-			password_is_set_f = 0;
-			EEPROM_readByte(IS_PASSWORD_SET_FLAG_LOCATION, &password_is_set_f);
-			if(password_is_set_f){
-				UART_sendByte(SETTED);
-			}else{
-				UART_sendByte(NOT_SETTED);
+	// Load the password and its flag once, the requests are served from the RAM copy
+	ConfigStore_init();
+	AuditLog_init();
+	AuditLog_setTimeSource(SwTimer_getMs);
+	Motion_init();
+	Motion_setCallBack(doorStepEvent);
+	DoorPosition_init();
+	Stall_init();
+	Stall_setCallBack(doorStallEvent);
+	Sound_init();
+	UserTable_init();
+
+	Power_init();
+	Power_setTimeSource(SwTimer_getMs);
+
+	// The tasks added first are served first, the protocol keeps the command latency low
+	Scheduler_init();
+	protocol_task = Scheduler_addTask(protocolTask);
+	door_task = Scheduler_addTask(doorTask);
+	alarm_task = Scheduler_addTask(alarmTask);
+	storage_task = Scheduler_addTask(storageTask);
+
+	// A reset does not shorten the lockout, it starts again
+	if(isLockedOut()){
+		Scheduler_post(alarm_task, EVENT_ALARM_START);
+	}
+
+	Scheduler_setIdleHook(enterSleep);
+	UART_setRxCallBack(uartRxEvent);
+	Scheduler_post(protocol_task, EVENT_UART_RX); // For the bytes received before the callback was set
+
+	Scheduler_run();
+}
+
+void protocolTask(uint8 event){
+	Protocol_FrameType frame;
+	Protocol_StatusType status;
+
+	uart_event_pending = 0; // The bytes received from now on post a new event
+
+	while((status = Protocol_poll(&frame)) != PROTOCOL_NO_FRAME){
+		if(status == PROTOCOL_FRAME_OK){
+			// A retry after a lost reply gets the same reply, the command is not run twice
+			if(!Protocol_resendReply(&frame)){
+				serveRequest(&frame);
 			}
+		}else{
+			Protocol_sendReply(&frame, FRAME_NACK, NULL_PTR, 0); // Ask the HMI to send the request again
+		}
+	}
+}
+
+void serveRequest(const Protocol_FrameType *frame){
+	uint8 passwords_are_matched_f;
+	uint8 status[3];
+	uint32 now;
+
+	switch(frame->opcode){
+	case IS_PASSWORD_SETTED:
+		if(ConfigStore_isPasswordSet()){
+			Protocol_sendReply(frame, SETTED, NULL_PTR, 0);
+		}else{
+			Protocol_sendReply(frame, NOT_SETTED, NULL_PTR, 0);
+		}
+		break;
+	case GET_READY_FOR_PASSWORD:
+		if(!recievePassword(frame, password_buffer)){
+			Protocol_sendReply(frame, FRAME_NACK, NULL_PTR, 0);
 			break;
-		case GET_READY_FOR_PASSWORD:
-			passwords_are_matched_f = 1;
-			recievePassword(password_buffer);
-			for(i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++){
-				EEPROM_readByte(i_counter,&password_temp_check);
-				if(password_buffer[i_counter] != password_temp_check){
-					passwords_are_matched_f = 0;
-				}
-				_delay_ms(15);
-			}
-			if(passwords_are_matched_f){
-				UART_sendByte(CORRECT_PASSWORD);
-			}else{
-				UART_sendByte(NOT_CORRECT_PASSWORD);
-			}
+		}
+		if(!ConfigStore_isPasswordSet()){
+			Protocol_sendReply(frame, NOT_SETTED, NULL_PTR, 0); // Let the HMI go back to the password setup
 			break;
-		case OPEN_DOOR:
-			Timer1_init(&Timer1_config);
-			DcMotor_Rotate(CW, FULL_SPEED);
-			while(timer1_ticks != 15);
-			timer1_ticks = 0;
-			Timer1_deinit();
-
-			Timer1_init(&Timer1_config);
-			DcMotor_Rotate(STOP, ZERO_SPEED);
-			while(timer1_ticks != 3);
-			timer1_ticks = 0;
-			Timer1_deinit();
-
-			Timer1_init(&Timer1_config);
-			DcMotor_Rotate(A_CW, FULL_SPEED);
-			while(timer1_ticks != 15);
-			timer1_ticks = 0;
-			Timer1_deinit();
-
-			DcMotor_Rotate(STOP, ZERO_SPEED);
+		}
+		if(isLockedOut()){
+			Protocol_sendReply(frame, NOT_CORRECT_PASSWORD, NULL_PTR, 0); // Not even checked, nor counted
+			master_verified = 0;
 			break;
-		case ERROR_ACTION:
-			Timer1_init(&Timer1_config);
-			Buzzer_on();
-			while(timer1_ticks != 60);
-			timer1_ticks = 0;
-			Timer1_deinit();
-			Buzzer_off();
+		}
+		// The door opens with the master password or the PIN of an enabled user
+		if(ConfigStore_checkPassword(password_buffer) || UserTable_checkPin(password_buffer, NULL_PTR)){
+			Protocol_sendReply(frame, CORRECT_PASSWORD, NULL_PTR, 0);
+			granted_attempts = failed_attempts;
+			failed_attempts = 0;
+		}else{
+			Protocol_sendReply(frame, NOT_CORRECT_PASSWORD, NULL_PTR, 0);
+			wrongPassword(); // Logged after the reply, the write runs in the background
+		}
+		master_verified = 0;
+		break;
+	case GET_READY_FOR_MASTER_PASSWORD:
+		if(!recievePassword(frame, password_buffer)){
+			Protocol_sendReply(frame, FRAME_NACK, NULL_PTR, 0);
 			break;
-		case GET_READY_FOR_PASSWORD_ONE:
-			recievePassword(password_buffer);
+		}
+		if(!ConfigStore_isPasswordSet()){
+			Protocol_sendReply(frame, NOT_SETTED, NULL_PTR, 0); // Let the HMI go back to the password setup
 			break;
-		case GET_READY_FOR_PASSWORD_TWO:
-			recievePassword(password_check_buffer);
+		}
+		if(isLockedOut()){
+			Protocol_sendReply(frame, NOT_CORRECT_PASSWORD, NULL_PTR, 0);
+			master_verified = 0;
 			break;
-		case IS_MATCHED:
-			passwords_are_matched_f = 1;
-
-			for(i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++){
-				if(password_buffer[i_counter] != password_check_buffer[i_counter]){
-					passwords_are_matched_f = 0;
-					break;
-				}
+		}
+		if(ConfigStore_checkPassword(password_buffer)){
+			Protocol_sendReply(frame, CORRECT_PASSWORD, NULL_PTR, 0);
+			failed_attempts = 0;
+			master_verified = 1;
+		}else{
+			Protocol_sendReply(frame, NOT_CORRECT_PASSWORD, NULL_PTR, 0);
+			wrongPassword();
+			master_verified = 0;
+		}
+		break;
+	case OPEN_DOOR:
+		Protocol_sendReply(frame, FRAME_ACK, NULL_PTR, 0); // Acknowledge before the door cycle starts
+		AuditLog_append(AUDIT_EVENT_UNLOCK, granted_attempts);
+		Scheduler_post(door_task, EVENT_DOOR_OPEN); // The door task moves the motor, the requests are still served meanwhile
+		break;
+	case ERROR_ACTION:
+		Protocol_sendReply(frame, FRAME_ACK, NULL_PTR, 0); // Acknowledge before the alarm starts
+		// Already running if the wrong passwords were counted here
+		if(!isLockedOut()){
+			startLockout();
+		}
+		break;
+	case GET_STATUS:
+		now = SwTimer_getMs();
+		status[0] = door_state;
+		status[1] = alarm_active;
+		status[2] = SwTimer_isReached(door_step_end) ? 0 : (uint8)((door_step_end - now + 999) / 1000); // Rounded up
+		Protocol_sendReply(frame, STATUS, status, sizeof(status));
+		break;
+	case GET_READY_FOR_PASSWORD_ONE:
+		if(recievePassword(frame, password_buffer)){
+			Protocol_sendReply(frame, FRAME_ACK, NULL_PTR, 0);
+		}else{
+			Protocol_sendReply(frame, FRAME_NACK, NULL_PTR, 0);
+		}
+		break;
+	case GET_READY_FOR_PASSWORD_TWO:
+		if(recievePassword(frame, password_check_buffer)){
+			Protocol_sendReply(frame, FRAME_ACK, NULL_PTR, 0);
+		}else{
+			Protocol_sendReply(frame, FRAME_NACK, NULL_PTR, 0);
+		}
+		break;
+	case IS_MATCHED:
+		passwords_are_matched_f = 1;
+
+		for(i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++){
+			if(password_buffer[i_counter] != password_check_buffer[i_counter]){
+				passwords_are_matched_f = 0;
+				break;
 			}
-			if(passwords_are_matched_f){
-				UART_sendByte(MATCHED);
+		}
+		// A saved password is only replaced after the master password has been entered
+		if(passwords_are_matched_f && (master_verified || !ConfigStore_isPasswordSet())){
+			// Flag and password are committed together, MATCHED is sent only once they are saved
+			if(ConfigStore_setPassword(password_buffer) == SUCCESS){
+				Protocol_sendReply(frame, MATCHED, NULL_PTR, 0);
+				AuditLog_append(AUDIT_EVENT_PASSWORD_CHANGED, 0);
+				master_verified = 0;
+			}else{
+				Protocol_sendReply(frame, NOT_MATCHED, NULL_PTR, 0);
+			}
+		}else{
+			Protocol_sendReply(frame, NOT_MATCHED, NULL_PTR, 0);
+		}
+		break;
+	case PLAY_SOUND:
+		// No reply, a lost chirp is not worth a retry. The alarm and the door patterns are
+		// only started here, the HMI can not start or silence them
+		if((frame->length == 1) && (frame->payload[0] == PLAY_SOUND_CHIRP)){
+			Sound_play(SOUND_CHIRP);
+		}
+		break;
+	case SET_STALL:
+		if(stallCommand(frame) == SUCCESS){
+			Protocol_sendReply(frame, FRAME_ACK, NULL_PTR, 0);
+		}else{
+			Protocol_sendReply(frame, USER_REFUSED, NULL_PTR, 0); // Refused like the user commands
+		}
+		break;
+	case USER_ADD:
+	case USER_REMOVE:
+	case USER_ENABLE:
+		if(userCommand(frame) == SUCCESS){
+			Protocol_sendReply(frame, FRAME_ACK, NULL_PTR, 0);
+		}else{
+			Protocol_sendReply(frame, USER_REFUSED, NULL_PTR, 0);
+		}
+		break;
+	default:
+		Protocol_sendReply(frame, FRAME_NACK, NULL_PTR, 0); // Unknown command
+		break;
+	}
 
-				EEPROM_writeByte(IS_PASSWORD_SET_FLAG_LOCATION, passwords_are_matched_f);
-				_delay_ms(15);
+	// Saved by the storage task, only written when it changed
+	Scheduler_post(storage_task, EVENT_SAVE_ATTEMPTS);
+}
 
-				for(i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++){
-					EEPROM_writeByte(i_counter, password_buffer[i_counter]);
-					_delay_ms(15);
-				}
+void doorTask(uint8 event){
+	switch(door_state){
+	case DOOR_CLOSED:
+		if(event == EVENT_DOOR_OPEN){
+			door_step_end = SwTimer_getMs() + Motion_getDuration(&door_profile);
+			doorMove(CW, DOOR_POSITION_OPEN);
+			door_state = DOOR_UNLOCKING;
+		}
+		break;
+	case DOOR_UNLOCKING:
+		if(event == EVENT_DOOR_STEP_OVER){
+			doorCheckArrival();
+			door_step_end = SwTimer_getMs() + DOOR_HOLD_TIME_MS;
+			SwTimer_start(&door_timer, DOOR_HOLD_TIME_MS, 0, doorStepEvent);
+			door_state = DOOR_HOLDING;
+		}
+		break;
+	case DOOR_HOLDING:
+		if(event == EVENT_DOOR_STEP_OVER){
+			door_step_end = SwTimer_getMs() + Motion_getDuration(&door_profile);
+			doorMove(A_CW, DOOR_POSITION_CLOSED);
+			Sound_play(SOUND_DOOR_CLOSING);
+			door_state = DOOR_LOCKING;
+		}
+		break;
+	case DOOR_LOCKING:
+		if(event == EVENT_DOOR_STEP_OVER){
+			Sound_stop(SOUND_DOOR_CLOSING);
+			doorCheckArrival();
+			if(door_stalled){
+				// Something blocks the door while it closes, open it again and keep the cycle going
+				door_step_end = SwTimer_getMs() + Motion_getDuration(&door_profile);
+				doorMove(CW, DOOR_POSITION_OPEN);
+				door_state = DOOR_UNLOCKING;
 			}else{
-				UART_sendByte(NOT_MATCHED);
+				door_state = DOOR_CLOSED;
 			}
-
-			_delay_ms(15);
-			break;
 		}
+		break;
+	}
+	// An EVENT_DOOR_OPEN during a cycle is dropped, the door is already opening or closes after it
+}
 
+void doorMove(DcMotor_State direction, DoorPosition_TargetType target){
+	door_stalled = 0;
+	Motion_start(direction, &door_profile);
+	DoorPosition_track(target);
+	Stall_arm();
+}
+
+void doorCheckArrival(void){
+	Stall_disarm();
+	if(door_stalled){
+		AuditLog_append(AUDIT_EVENT_DOOR_STALL, door_state);
+	}else if(DoorPosition_isTracking()){
+		AuditLog_append(AUDIT_EVENT_DOOR_FAULT, door_state);
 	}
+	DoorPosition_track(DOOR_POSITION_NONE);
 }
 
+void alarmTask(uint8 event){
+	if(event == EVENT_ALARM_START){
+		// A new lockout during the alarm starts the 60 seconds again
+		Sound_play(SOUND_ALARM);
+		SwTimer_start(&alarm_timer, ALARM_TIME_MS, 0, alarmTimerEvent);
+		alarm_active = 1;
+	}else{
+		Sound_stop(SOUND_ALARM);
+		alarm_active = 0;
+		failed_attempts = 0; // End of the lockout, the passwords are checked again
+		Scheduler_post(storage_task, EVENT_SAVE_ATTEMPTS);
+	}
+}
 
-void recievePassword(uint8 *password){
+void storageTask(uint8 event){
+	// Queued for the EEPROM ready interrupt, try again after one write cycle if the queue is full
+	if(!IEEPROM_writeByte(FAILED_ATTEMPTS_ADDRESS, failed_attempts)){
+		SwTimer_start(&storage_timer, STORAGE_RETRY_MS, 0, storageTimerEvent);
+	}
+}
+
+void uartRxEvent(void){
+	if(!uart_event_pending){
+		uart_event_pending = 1;
+		Scheduler_post(protocol_task, EVENT_UART_RX);
+	}
+}
+
+void doorStepEvent(void){
+	Scheduler_post(door_task, EVENT_DOOR_STEP_OVER);
+}
+
+void doorStallEvent(void){
+	// The braking current of a move already ending is not a stall
+	if((Motion_getPhase() != MOTION_IDLE) && (Motion_getPhase() != MOTION_BRAKING)){
+		door_stalled = 1;
+		Motion_brake(); // The end of the move posts EVENT_DOOR_STEP_OVER
+	}
+}
+
+void alarmTimerEvent(void){
+	Scheduler_post(alarm_task, EVENT_ALARM_TIMER);
+}
+
+void storageTimerEvent(void){
+	Scheduler_post(storage_task, EVENT_SAVE_ATTEMPTS);
+}
+
+void enterSleep(void){
+	Power_sleep(POWER_IDLE);
+}
+
+void wrongPassword(void){
+	failed_attempts++;
+	AuditLog_append(AUDIT_EVENT_WRONG_PASSWORD, failed_attempts);
+	if(failed_attempts >= PASSWORD_TRIES){
+		startLockout();
+	}
+}
+
+void startLockout(void){
+	AuditLog_append(AUDIT_EVENT_LOCKOUT, failed_attempts);
+	failed_attempts = PASSWORD_TRIES; // Refused until the alarm is over, the counter stops here
+	Scheduler_post(alarm_task, EVENT_ALARM_START);
+}
+
+uint8 isLockedOut(void){
+	return failed_attempts >= PASSWORD_TRIES;
+}
+
+uint8 checkCommandPassword(const Protocol_FrameType *frame){
+	if(isLockedOut()){
+		return 0;
+	}
+	if(!ConfigStore_checkPassword(frame->payload)){
+		wrongPassword(); // Saved by the storage task posted after the request
+		return 0;
+	}
+	failed_attempts = 0;
+	return 1;
+}
+
+uint8 recievePassword(const Protocol_FrameType *frame, uint8 *password){
+	if(frame->length != PASSWORD_SIZE){
+		return 0;
+	}
 	for(i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++){
-		*(password+i_counter) = UART_recieveByte();
-		_delay_ms(15);
+		*(password+i_counter) = frame->payload[i_counter];
+	}
+	return 1;
+}
+
+uint8 userCommand(const Protocol_FrameType *frame){
+	uint8 id;
+
+	if((frame->length <= PASSWORD_SIZE) || !checkCommandPassword(frame)){
+		return ERROR;
+	}
+	id = frame->payload[PASSWORD_SIZE];
+
+	switch(frame->opcode){
+	case USER_ADD:
+		if(frame->length != (2 * PASSWORD_SIZE) + 1){
+			return ERROR;
+		}
+		return UserTable_add(id, &frame->payload[PASSWORD_SIZE + 1]);
+	case USER_REMOVE:
+		if(frame->length != PASSWORD_SIZE + 1){
+			return ERROR;
+		}
+		return UserTable_remove(id);
+	default:
+		if(frame->length != PASSWORD_SIZE + 2){
+			return ERROR;
+		}
+		return UserTable_setEnabled(id, frame->payload[PASSWORD_SIZE + 1]);
 	}
 }
 
-void timer1TickIncrement(void) {
-    timer1_ticks++; // Increment the volatile variable timer1_ticks
+uint8 stallCommand(const Protocol_FrameType *frame){
+	uint16 threshold;
+	uint8 window;
+
+	if((frame->length != PASSWORD_SIZE + 3) || !checkCommandPassword(frame)){
+		return ERROR;
+	}
+	threshold = ((uint16)frame->payload[PASSWORD_SIZE] << 8) | frame->payload[PASSWORD_SIZE + 1];
+	window = frame->payload[PASSWORD_SIZE + 2];
+
+	// Both are checked first so a refused frame changes nothing
+	if((threshold == 0) || (threshold > ADC_MAXIMUM_VALUE) || (window == 0) || (window > ADC_MAX_WINDOW)){
+		return ERROR;
+	}
+	Stall_setThreshold(threshold);
+	Stall_setWindow(window);
+	return SUCCESS;
 }
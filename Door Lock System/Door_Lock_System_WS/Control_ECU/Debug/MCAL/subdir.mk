@@ -4,23 +4,35 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../MCAL/adc.c \
+../MCAL/ext_interrupt.c \
 ../MCAL/gpio.c \
+../MCAL/internal_eeprom.c \
 ../MCAL/timer0_pwm.c \
 ../MCAL/timer1.c \
+../MCAL/timer2.c \
 ../MCAL/twi.c \
 ../MCAL/uart.c 
 
 OBJS += \
+./MCAL/adc.o \
+./MCAL/ext_interrupt.o \
 ./MCAL/gpio.o \
+./MCAL/internal_eeprom.o \
 ./MCAL/timer0_pwm.o \
 ./MCAL/timer1.o \
+./MCAL/timer2.o \
 ./MCAL/twi.o \
 ./MCAL/uart.o 
 
 C_DEPS += \
+./MCAL/adc.d \
+./MCAL/ext_interrupt.d \
 ./MCAL/gpio.d \
+./MCAL/internal_eeprom.d \
 ./MCAL/timer0_pwm.d \
 ./MCAL/timer1.d \
+./MCAL/timer2.d \
 ./MCAL/twi.d \
 ./MCAL/uart.d 
 
@@ -0,0 +1,57 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../SERVICE/audit_log.c \
+../SERVICE/config_store.c \
+../SERVICE/door_position.c \
+../SERVICE/log_store.c \
+../SERVICE/motion_profile.c \
+../SERVICE/power.c \
+../SERVICE/protocol.c \
+../SERVICE/scheduler.c \
+../SERVICE/sound.c \
+../SERVICE/stall_detector.c \
+../SERVICE/sw_timer.c \
+../SERVICE/user_table.c 
+
+OBJS += \
+./SERVICE/audit_log.o \
+./SERVICE/config_store.o \
+./SERVICE/door_position.o \
+./SERVICE/log_store.o \
+./SERVICE/motion_profile.o \
+./SERVICE/power.o \
+./SERVICE/protocol.o \
+./SERVICE/scheduler.o \
+./SERVICE/sound.o \
+./SERVICE/stall_detector.o \
+./SERVICE/sw_timer.o \
+./SERVICE/user_table.o 
+
+C_DEPS += \
+./SERVICE/audit_log.d \
+./SERVICE/config_store.d \
+./SERVICE/door_position.d \
+./SERVICE/log_store.d \
+./SERVICE/motion_profile.d \
+./SERVICE/power.d \
+./SERVICE/protocol.d \
+./SERVICE/scheduler.d \
+./SERVICE/sound.d \
+./SERVICE/stall_detector.d \
+./SERVICE/sw_timer.d \
+./SERVICE/user_table.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+SERVICE/%.o: ../SERVICE/%.c SERVICE/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -22,4 +22,5 @@ SUBDIRS := \
 . \
 HAL \
 MCAL \
+SERVICE \
 
@@ -7,16 +7,48 @@
 
 #include "buzzer.h"
 #include "../MCAL/gpio.h"
+#include "../MCAL/timer2.h"
+
+/* Division of each Timer2 prescaler as a shift, from the finest one */
+static const uint8 g_prescalerShift[] = {0, 3, 5, 6, 7, 8, 10};
 
 void Buzzer_init(void){
 	GPIO_setupPinDirection(BUZZER_PORT_ID,BUZZER_PIN_ID,PIN_OUTPUT);
-	GPIO_writePin(BUZZER_PORT_ID,BUZZER_PIN_ID,LOGIC_LOW);
+	Timer2_stop();
 }
 
 void Buzzer_on(void){
-	GPIO_writePin(BUZZER_PORT_ID,BUZZER_PIN_ID,LOGIC_HIGH);
+	Buzzer_tone(BUZZER_DEFAULT_FREQUENCY);
 }
 
 void Buzzer_off(void){
-	GPIO_writePin(BUZZER_PORT_ID,BUZZER_PIN_ID,LOGIC_LOW);
+	Timer2_stop();
+}
+
+void Buzzer_tone(uint16 frequency){
+	Timer2_ConfigType Timer2_config;
+	uint32 half_period; /* Timer clocks without prescaler in half a period */
+	uint8 i;
+
+	if(frequency == 0){
+		Timer2_stop();
+		return;
+	}
+
+	half_period = (F_CPU / 2) / frequency;
+
+	/* The finest prescaler giving a compare value that fits in 8 bits is the most accurate */
+	for(i = 0; i < sizeof(g_prescalerShift); i++){
+		if((half_period >> g_prescalerShift[i]) <= 256){
+			break;
+		}
+	}
+	if(i == sizeof(g_prescalerShift)){
+		i--; /* Below the range, the lowest tone */
+		half_period = (uint32)256 << g_prescalerShift[i];
+	}
+
+	Timer2_config.prescaler = (Timer2_Prescaler)(TIMER2_NO_PRESCALER + i);
+	Timer2_config.compare_value = (uint8)((half_period >> g_prescalerShift[i]) - 1);
+	Timer2_startSquareWave(&Timer2_config);
 }
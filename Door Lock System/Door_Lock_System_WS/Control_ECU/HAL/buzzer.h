@@ -10,8 +10,12 @@
 
 #include "../LIB/std_types.h"
 
-#define BUZZER_PORT_ID PORTB_ID
-#define BUZZER_PIN_ID PIN0_ID
+/* Passive buzzer on OC2, driven with a square wave from Timer2 */
+#define BUZZER_PORT_ID PORTD_ID
+#define BUZZER_PIN_ID PIN7_ID
+
+/* Tone of Buzzer_on, in Hz */
+#define BUZZER_DEFAULT_FREQUENCY 2000
 
 void Buzzer_init(void);
 
@@ -19,5 +23,8 @@ void Buzzer_on(void);
 
 void Buzzer_off(void);
 
+/* Play frequency in Hz until the next call, 0 is silence. Lowest tone about 16 Hz at 8 MHz */
+void Buzzer_tone(uint16 frequency);
+
 
 #endif /* BUZZER_H_ */
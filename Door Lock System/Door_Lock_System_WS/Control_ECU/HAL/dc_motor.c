@@ -15,13 +15,21 @@
 // Function to initialize the DC motor
 void DcMotor_Init(void){
 
+    PWM_Timer0_ConfigType PWM_config = {
+            .mode = DC_MOTOR_PWM_MODE,
+            .prescaler = DC_MOTOR_PWM_PRESCALER
+    };
+
     // Configure PINA and PINB as output pins for motor terminals
-    GPIO_setupPinDirection(PORT_ID, PINA_ID, PIN_OUTPUT);
-    GPIO_setupPinDirection(PORT_ID, PINB_ID, PIN_OUTPUT);
+    GPIO_SETUP_PIN_DIRECTION(PORT_ID, PINA_ID, PIN_OUTPUT);
+    GPIO_SETUP_PIN_DIRECTION(PORT_ID, PINB_ID, PIN_OUTPUT);
 
     // Set initial states of PINA and PINB to LOGIC_LOW for motor stop
-    GPIO_writePin(PORT_ID, PINA_ID, LOGIC_LOW);
-    GPIO_writePin(PORT_ID, PINB_ID, LOGIC_LOW);
+    GPIO_WRITE_PIN(PORT_ID, PINA_ID, LOGIC_LOW);
+    GPIO_WRITE_PIN(PORT_ID, PINB_ID, LOGIC_LOW);
+
+    // PWM stopped while the motor is stopped
+    PWM_Timer0_init(&PWM_config);
 }
 
 // Function to control the DC motor rotation
@@ -30,24 +38,37 @@ void DcMotor_Rotate(DcMotor_State state, uint8 speed){
     switch(state){
         case CW:
             // Drive the motor in Clockwise direction
-            GPIO_writePin(PORT_ID, PINA_ID, LOGIC_LOW);
-            GPIO_writePin(PORT_ID, PINB_ID, LOGIC_HIGH);
+            GPIO_WRITE_PIN(PORT_ID, PINA_ID, LOGIC_LOW);
+            GPIO_WRITE_PIN(PORT_ID, PINB_ID, LOGIC_HIGH);
             // Start PWM to control motor speed based on speed parameter
             PWM_Timer0_Start(((speed * 255) / 100));
             break;
         case A_CW:
             // Drive the motor in Anti-Clockwise direction
-            GPIO_writePin(PORT_ID, PINA_ID, LOGIC_HIGH);
-            GPIO_writePin(PORT_ID, PINB_ID, LOGIC_LOW);
+            GPIO_WRITE_PIN(PORT_ID, PINA_ID, LOGIC_HIGH);
+            GPIO_WRITE_PIN(PORT_ID, PINB_ID, LOGIC_LOW);
             // Start PWM to control motor speed based on speed parameter
             PWM_Timer0_Start(((speed * 255) / 100));
             break;
         case STOP:
             // Stop the motor by setting both terminals to LOGIC_LOW
-            GPIO_writePin(PORT_ID, PINA_ID, LOGIC_LOW);
-            GPIO_writePin(PORT_ID, PINB_ID, LOGIC_LOW);
-            // Start PWM to control motor speed based on speed parameter
+            GPIO_WRITE_PIN(PORT_ID, PINA_ID, LOGIC_LOW);
+            GPIO_WRITE_PIN(PORT_ID, PINB_ID, LOGIC_LOW);
+            // No PWM needed, Timer0 is stopped
+            PWM_Timer0_Stop();
+            break;
+        case BRAKE:
+            // Brake the motor by setting both terminals to LOGIC_HIGH, the speed sets the braking strength
+            GPIO_WRITE_PIN(PORT_ID, PINA_ID, LOGIC_HIGH);
+            GPIO_WRITE_PIN(PORT_ID, PINB_ID, LOGIC_HIGH);
             PWM_Timer0_Start(((speed * 255) / 100));
             break;
     }
 }
+
+// Function to change the motor speed
+void DcMotor_setSpeed(uint8 speed){
+
+    // Only the duty cycle changes, at the end of the PWM period
+    PWM_Timer0_setDutyCycle(((speed * 255) / 100));
+}
@@ -22,11 +22,16 @@
 #define FULL_SPEED 100
 #define ZERO_SPEED 0
 
+// PWM of the motor driver, fast PWM at 8 MHz / 8 / 256 = 3.9 kHz
+#define DC_MOTOR_PWM_MODE PWM_FAST
+#define DC_MOTOR_PWM_PRESCALER PWM_PRESCALER_8
+
 // Define an enumeration type DcMotor_State to represent motor states
 typedef enum{
     CW,    // Clockwise rotation
     A_CW,  // Anti-clockwise rotation
-    STOP   // Motor stop
+    STOP,  // Motor stop, left free to coast
+    BRAKE  // Active brake, both terminals high so the motor is shorted
 }DcMotor_State;
 
 // Function to initialize the DC motor
@@ -35,4 +40,7 @@ void DcMotor_Init(void);
 // Function to control the DC motor rotation
 void DcMotor_Rotate(DcMotor_State state, uint8 speed);
 
+// Function to change the speed of the running motor without touching its direction
+void DcMotor_setSpeed(uint8 speed);
+
 #endif
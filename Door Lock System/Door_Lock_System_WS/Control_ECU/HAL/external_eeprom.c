@@ -11,72 +11,387 @@
  *******************************************************************************/
 #include "external_eeprom.h"
 #include "../MCAL/twi.h"
+#include <util/delay.h>
 
-uint8 EEPROM_writeByte(uint16 u16addr, uint8 u8data)
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Where a linear address falls */
+typedef struct{
+    uint8 device; /* Slave address with the block bits of the 1 byte address parts, R/W=0 */
+    uint8 address_size;
+    uint8 page_size;
+    uint16 word; /* Address inside the device */
+    uint32 left; /* Bytes from the address to the end of the device */
+}EEPROM_LocationType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const EEPROM_DeviceType g_devices[] = EEPROM_DEVICE_TABLE;
+
+#define EEPROM_DEVICES (sizeof(g_devices) / sizeof(g_devices[0]))
+
+/* Device polled by EEPROM_isBusy, the one written last */
+static uint8 g_lastDevice = 0xA0;
+
+/* A page was written, blocking or queued, and its write cycle may still be running */
+static volatile boolean g_writeCycle = False;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 EEPROM_locate(uint32 u32addr, EEPROM_LocationType *location);
+static uint8 EEPROM_sendAddress(const EEPROM_LocationType *location);
+static uint8 EEPROM_writePage(const EEPROM_LocationType *location, const uint8 *u8data, uint8 u8size);
+static uint8 EEPROM_readSequential(const EEPROM_LocationType *location, uint8 *u8data, uint16 u16size);
+static uint8 EEPROM_failure(void);
+static uint8 EEPROM_waitWriteCycle(void);
+
+uint8 EEPROM_writeByte(uint32 u32addr, uint8 u8data)
 {
-	/* Send the Start Bit */
+    EEPROM_LocationType location;
+
+    uint8 status;
+
+    if(EEPROM_locate(u32addr, &location) != SUCCESS)
+        return ERROR;
+
+    status = EEPROM_waitWriteCycle();
+    if(status != SUCCESS)
+        return status;
+
+    return EEPROM_writePage(&location, &u8data, 1);
+}
+
+uint8 EEPROM_readByte(uint32 u32addr, uint8 *u8data)
+{
+    return EEPROM_readBlock(u32addr, u8data, 1);
+}
+
+uint32 EEPROM_getSize(void)
+{
+    uint32 size = 0;
+    uint8 i;
+
+    for(i = 0; i < EEPROM_DEVICES; i++)
+        size += g_devices[i].size;
+
+    return size;
+}
+
+boolean EEPROM_isBusy(void)
+{
+    boolean busy;
+
+	/* Send the Start Bit, a bus that can not be taken counts as busy */
     TWI_start();
     if (TWI_getStatus() != TWI_START)
+    {
+        EEPROM_failure();
+        return True;
+    }
+
+    /* Any block address works, the whole device is busy during a write cycle */
+    TWI_writeByte(g_lastDevice);
+    busy = (TWI_getStatus() != TWI_MT_SLA_W_ACK);
+
+    /* Send the Stop Bit */
+    TWI_stop();
+
+    return busy;
+}
+
+uint8 EEPROM_waitReady(void)
+{
+    uint16 retries;
+
+    for(retries = 0; retries < EEPROM_ACK_POLL_MAX_RETRIES; retries++)
+    {
+        if(!EEPROM_isBusy())
+        {
+            g_writeCycle = False;
+            return SUCCESS;
+        }
+        if(TWI_getStatus() == TWI_TIMEOUT)
+            return BUS_TIMEOUT;
+        _delay_us(EEPROM_ACK_POLL_INTERVAL_US);
+    }
+
+    return ERROR;
+}
+
+uint8 EEPROM_writeBlock(uint32 u32addr, const uint8 *u8data, uint16 u16size)
+{
+    EEPROM_LocationType location;
+    uint8 chunk;
+    uint8 status;
+
+    while(u16size != 0)
+    {
+        if(EEPROM_locate(u32addr, &location) != SUCCESS)
+            return ERROR;
+
+        /* Write up to the end of the current page, the device wraps inside the page otherwise.
+         * The devices hold whole pages, so this never crosses a device either. */
+        chunk = location.page_size - (location.word & (location.page_size - 1));
+        if(chunk > u16size)
+            chunk = u16size;
+
+        /* The device does not answer until the previous page is programmed */
+        status = EEPROM_waitWriteCycle();
+        if(status != SUCCESS)
+            return status;
+
+        status = EEPROM_writePage(&location, u8data, chunk);
+        if(status != SUCCESS)
+            return status;
+
+        u32addr += chunk;
+        u8data += chunk;
+        u16size -= chunk;
+    }
+
+    return SUCCESS;
+}
+
+uint8 EEPROM_readBlock(uint32 u32addr, uint8 *u8data, uint16 u16size)
+{
+    EEPROM_LocationType location;
+    uint16 chunk;
+    uint8 status;
+
+    while(u16size != 0)
+    {
+        if(EEPROM_locate(u32addr, &location) != SUCCESS)
+            return ERROR;
+
+        /* A sequential read wraps inside its device, continue on the next one */
+        chunk = (location.left < u16size) ? (uint16)location.left : u16size;
+
+        /* A write cycle still running would NACK the address */
+        status = EEPROM_waitWriteCycle();
+        if(status != SUCCESS)
+            return status;
+
+        status = EEPROM_readSequential(&location, u8data, chunk);
+        if(status != SUCCESS)
+            return status;
+
+        u32addr += chunk;
+        u8data += chunk;
+        u16size -= chunk;
+    }
+
+    return SUCCESS;
+}
+
+uint8 EEPROM_readBlockAsync(uint32 u32addr, uint8 *u8data, uint8 u8size, void (*callback)(uint8 status))
+{
+    EEPROM_LocationType location;
+    TWI_TransactionType transaction;
+
+    if((EEPROM_locate(u32addr, &location) != SUCCESS) || (location.left < u8size))
         return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
-    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
-        return ERROR; 
-		 
-    /* Send the required memory location address */
-    TWI_writeByte((uint8)(u16addr));
-    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+
+    transaction.device = location.device;
+    transaction.address = location.word;
+    transaction.address_size = location.address_size;
+    transaction.buffer = u8data;
+    transaction.length = u8size;
+    transaction.direction = TWI_READ;
+    transaction.callback = callback;
+
+    return TWI_submit(&transaction) ? SUCCESS : ERROR;
+}
+
+uint8 EEPROM_writePageAsync(uint32 u32addr, const uint8 *u8data, uint8 u8size, void (*callback)(uint8 status))
+{
+    EEPROM_LocationType location;
+    TWI_TransactionType transaction;
+
+    if(EEPROM_locate(u32addr, &location) != SUCCESS)
         return ERROR;
-		
-    /* write byte to eeprom */
-    TWI_writeByte(u8data);
-    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+
+    if(((location.word & (location.page_size - 1)) + u8size) > location.page_size)
         return ERROR;
 
-    /* Send the Stop Bit */
-    TWI_stop();
-	
+    transaction.device = location.device;
+    transaction.address = location.word;
+    transaction.address_size = location.address_size;
+    transaction.buffer = (uint8 *)u8data; /* Only read by the engine for a write */
+    transaction.length = u8size;
+    transaction.direction = TWI_WRITE;
+    transaction.callback = callback;
+
+    if(!TWI_submit(&transaction))
+        return ERROR;
+
+    g_lastDevice = location.device;
+    g_writeCycle = True;
     return SUCCESS;
 }
 
-uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
+/*
+ * Description :
+ * Find the device of a linear address and the address inside it.
+ * Returns ERROR if the address is after the last device.
+ */
+static uint8 EEPROM_locate(uint32 u32addr, EEPROM_LocationType *location)
+{
+    uint8 i;
+
+    for(i = 0; i < EEPROM_DEVICES; i++)
+    {
+        if(u32addr < g_devices[i].size)
+        {
+            location->word = (uint16)u32addr;
+            location->left = g_devices[i].size - u32addr;
+            location->address_size = g_devices[i].address_size;
+            location->page_size = g_devices[i].page_size;
+
+            /* The 1 byte address parts take A8 A9 A10 in the slave address */
+            location->device = g_devices[i].device;
+            if(location->address_size == 1)
+                location->device |= (uint8)((location->word & 0x0700) >> 7);
+
+            return SUCCESS;
+        }
+        u32addr -= g_devices[i].size;
+    }
+
+    return ERROR;
+}
+
+/*
+ * Description :
+ * Send START, the slave address with R/W=0 and the word address, high byte first.
+ */
+static uint8 EEPROM_sendAddress(const EEPROM_LocationType *location)
 {
 	/* Send the Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=0 (write) */
-    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
+        return EEPROM_failure();
+
+    /* Send the device address with R/W=0 (write) */
+    TWI_writeByte(location->device);
     if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
-        return ERROR;
-		
-    /* Send the required memory location address */
-    TWI_writeByte((uint8)(u16addr));
+        return EEPROM_failure();
+
+    /* Send the memory location address */
+    if(location->address_size == 2)
+    {
+        TWI_writeByte((uint8)(location->word >> 8));
+        if (TWI_getStatus() != TWI_MT_DATA_ACK)
+            return EEPROM_failure();
+    }
+    TWI_writeByte((uint8)(location->word));
     if (TWI_getStatus() != TWI_MT_DATA_ACK)
-        return ERROR;
-		
+        return EEPROM_failure();
+
+    return SUCCESS;
+}
+
+/*
+ * Description :
+ * Write up to one page of data in a single START/SLA/ADDR/DATA.../STOP transaction.
+ * The data should not cross a page boundary.
+ */
+static uint8 EEPROM_writePage(const EEPROM_LocationType *location, const uint8 *u8data, uint8 u8size)
+{
+    uint8 status;
+    uint8 i;
+
+    status = EEPROM_sendAddress(location);
+    if(status != SUCCESS)
+        return status;
+
+    /* write the page bytes to eeprom, the device increments the address after each byte */
+    for(i = 0; i < u8size; i++)
+    {
+        TWI_writeByte(u8data[i]);
+        if (TWI_getStatus() != TWI_MT_DATA_ACK)
+            return EEPROM_failure();
+    }
+
+    /* Send the Stop Bit, the device starts its write cycle */
+    TWI_stop();
+    g_lastDevice = location->device;
+    g_writeCycle = True;
+
+    return SUCCESS;
+}
+
+/*
+ * Description :
+ * Read u16size bytes inside one device with one sequential read transaction.
+ */
+static uint8 EEPROM_readSequential(const EEPROM_LocationType *location, uint8 *u8data, uint16 u16size)
+{
+    uint8 status;
+    uint16 i;
+
+    status = EEPROM_sendAddress(location);
+    if(status != SUCCESS)
+        return status;
+
     /* Send the Repeated Start Bit */
     TWI_start();
     if (TWI_getStatus() != TWI_REP_START)
-        return ERROR;
-		
-    /* Send the device address, we need to get A8 A9 A10 address bits from the
-     * memory location address and R/W=1 (Read) */
-    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
+        return EEPROM_failure();
+
+    /* Send the device address with R/W=1 (Read) */
+    TWI_writeByte((uint8)(location->device | 1));
     if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
-        return ERROR;
+        return EEPROM_failure();
 
-    /* Read Byte from Memory without send ACK */
-    *u8data = TWI_readByteWithNACK();
+    /* ACK every byte except the last one so the device keeps sending the next location */
+    for(i = 0; i < (u16size - 1); i++)
+    {
+        u8data[i] = TWI_readByteWithACK();
+        if (TWI_getStatus() != TWI_MR_DATA_ACK)
+            return EEPROM_failure();
+    }
+
+    /* Read the last byte without ACK to end the sequential read */
+    u8data[i] = TWI_readByteWithNACK();
     if (TWI_getStatus() != TWI_MR_DATA_NACK)
-        return ERROR;
+        return EEPROM_failure();
 
     /* Send the Stop Bit */
     TWI_stop();
 
     return SUCCESS;
 }
+
+/*
+ * Description :
+ * Exit of every failed status check, releases the bus and tells a bus timeout apart from
+ * a protocol error. After a NACK the master still holds the bus and the next start would
+ * be a repeated start, so a STOP is sent. A timeout already recovered the bus with a STOP.
+ */
+static uint8 EEPROM_failure(void)
+{
+    if (TWI_getStatus() == TWI_TIMEOUT)
+        return BUS_TIMEOUT;
+
+    TWI_stop();
+    return ERROR;
+}
+
+/*
+ * Description :
+ * Wait for the write cycle of the last page written, blocking or queued, if it may still
+ * be running. Returns SUCCESS at once otherwise.
+ */
+static uint8 EEPROM_waitWriteCycle(void)
+{
+    if(!g_writeCycle)
+        return SUCCESS;
+
+    return EEPROM_waitReady();
+}
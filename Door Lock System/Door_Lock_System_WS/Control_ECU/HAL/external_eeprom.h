@@ -21,12 +21,112 @@
  *******************************************************************************/
 #define ERROR 0
 #define SUCCESS 1
+#define BUS_TIMEOUT 2 /* The TWI bus did not answer in time and was recovered */
+
+/*
+ * Devices on the bus, they form one linear address space in the order of the table.
+ * Each entry is { slave address, word address bytes, page size, size in bytes }:
+ * - The slave address is 0xA0 with the A2 A1 A0 pins of the chip shifted left by one.
+ *   The 24C01 to 24C16 use one word address byte and take the upper address bits
+ *   in place of these pins, so they are alone at 0xA0.
+ * - The 24C32 to 24C512 use two word address bytes, up to eight of them can share
+ *   the bus with different pins.
+ * Example with two 24C256 chips: { {0xA0, 2, 64, 32768UL}, {0xA2, 2, 64, 32768UL} }
+ */
+#define EEPROM_DEVICE_TABLE { {0xA0, 1, 16, 2048UL} } /* One 24C16 */
+
+/*
+ * Page alignment used by the upper layers, records aligned on it never cross a device page.
+ * Should divide the page size of every device in the table.
+ */
+#define EEPROM_PAGE_SIZE 16
+#define EEPROM_WRITE_CYCLE_TIME_MS 10 /* Worst case internal write cycle time (tWR) */
+
+/*
+ * The device does not acknowledge its address during a write cycle, so completion is
+ * detected by polling the address. The retries cover twice the worst case write cycle.
+ */
+#define EEPROM_ACK_POLL_INTERVAL_US 50
+#define EEPROM_ACK_POLL_MAX_RETRIES ((EEPROM_WRITE_CYCLE_TIME_MS * 2000UL) / EEPROM_ACK_POLL_INTERVAL_US)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct{
+	uint8 device; /* Slave address with R/W bit = 0 */
+	uint8 address_size; /* Word address bytes, 1 or 2 */
+	uint8 page_size; /* Bytes written in one write cycle, a power of two */
+	uint32 size; /* Capacity in bytes, a multiple of the page size */
+}EEPROM_DeviceType;
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
-uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
-uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
+/*
+ * All the blocking functions return SUCCESS, ERROR when the device did not answer as
+ * expected or the address is out of the devices, or BUS_TIMEOUT when the TWI bus hung
+ * and had to be recovered. Addresses are in the linear space of EEPROM_DEVICE_TABLE.
+ * They first wait for the write cycle of the last page written, blocking or queued, so
+ * they can follow an EEPROM_writePageAsync right away.
+ */
+
+uint8 EEPROM_writeByte(uint32 u32addr,uint8 u8data);
+uint8 EEPROM_readByte(uint32 u32addr,uint8 *u8data);
+
+/*
+ * Description :
+ * Returns the size of the linear address space, the sum of the device sizes.
+ */
+uint32 EEPROM_getSize(void);
+
+/*
+ * Description :
+ * Check if the device written last is still in its internal write cycle by sending its
+ * address once. Returns True while the device does not acknowledge.
+ */
+boolean EEPROM_isBusy(void);
+
+/*
+ * Description :
+ * Poll the device address until it acknowledges, bounded by EEPROM_ACK_POLL_MAX_RETRIES.
+ * Returns SUCCESS as soon as the device is ready, ERROR if it never answered.
+ * The blocking functions call it when a write cycle may be running.
+ */
+uint8 EEPROM_waitReady(void);
+
+/*
+ * Description :
+ * Write u16size bytes starting from u32addr. The block is split at the page and device
+ * boundaries and each page part is sent in one TWI transaction, so it costs one write
+ * cycle per page. The function polls for the write cycle before each page but not after the last one.
+ */
+uint8 EEPROM_writeBlock(uint32 u32addr, const uint8 *u8data, uint16 u16size);
+
+/*
+ * Description :
+ * Read u16size bytes starting from u32addr with one sequential read transaction per device.
+ * The address is sent once, then the bytes are streamed with ACK and the last one with NACK.
+ */
+uint8 EEPROM_readBlock(uint32 u32addr, uint8 *u8data, uint16 u16size);
+
+/*
+ * Description :
+ * Queue a sequential read of u8size bytes starting from u32addr on the TWI engine and return,
+ * the data should not cross a device boundary.
+ * The callback is called from the TWI ISR with TWI_TRANSACTION_OK or the failing TWSR status,
+ * u8data must stay valid until then. Returns ERROR if the TWI queue is full.
+ */
+uint8 EEPROM_readBlockAsync(uint32 u32addr, uint8 *u8data, uint8 u8size, void (*callback)(uint8 status));
+
+/*
+ * Description :
+ * Queue a write of up to one page on the TWI engine and return, the data should not cross
+ * a page boundary. If the device is still busy with a previous write cycle the engine
+ * keeps polling its address, so page writes can be queued back to back.
+ * The callback is called like in EEPROM_readBlockAsync. Returns ERROR if the TWI queue is full.
+ */
+uint8 EEPROM_writePageAsync(uint32 u32addr, const uint8 *u8data, uint8 u8size, void (*callback)(uint8 status));
  
 #endif /* EXTERNAL_EEPROM_H_ */
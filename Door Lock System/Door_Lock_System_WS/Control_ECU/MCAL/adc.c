@@ -0,0 +1,153 @@
+ /******************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.c
+ *
+ * Description: Source file for the AVR ADC driver in free running mode
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "adc.h"
+#include "avr/io.h"
+#include "avr/interrupt.h"
+
+/* Define a pointer to function that will hold the address of the callback function */
+static void (*volatile ADC_CallBack_Ptr)(uint16 average) = NULL_PTR;
+
+/* Last samples in a ring, changed by the ISR and by the functions below with the interrupts disabled */
+static volatile uint16 g_samples[ADC_MAX_WINDOW];
+static volatile uint16 g_sum = 0; /* Sum of the g_count samples in the ring */
+static volatile uint8 g_count = 0;
+static volatile uint8 g_index = 0; /* Next sample to replace */
+static volatile uint8 g_window = 1;
+
+/*
+ * Description:
+ * Empty the moving average. Called with the interrupts disabled.
+ */
+static void ADC_clearAverage(void){
+    g_sum = 0;
+    g_count = 0;
+    g_index = 0;
+}
+
+/*
+ * Description:
+ * Enable the ADC with the reference and the prescaler of the configuration.
+ */
+void ADC_init(const ADC_ConfigType * Config_Ptr){
+    /* Reference voltage (REFS1:0), right adjusted result, channel 0 */
+    ADMUX = ((Config_Ptr -> ref_volt) << 6) & 0xC0;
+
+    /* Free running is the auto trigger source 0 (ADTS2:0) */
+    SFIOR &= 0x1F;
+
+    /* ADC on, clock prescaler (ADPS2:0), no conversion and no interrupt yet */
+    ADCSRA = (1<<ADEN) | ((Config_Ptr -> prescaler) & 0x07);
+
+    ADC_setWindow(1);
+}
+
+/*
+ * Description:
+ * Stop the conversions and turn the ADC off.
+ */
+void ADC_deinit(void){
+    ADCSRA = 0x00;
+}
+
+/*
+ * Description:
+ * Start the free running conversions of channel with the interrupt.
+ */
+void ADC_startFreeRunning(uint8 channel){
+    uint8 sreg;
+
+    sreg = SREG;
+    cli();
+
+    ADC_stop();
+    ADMUX = (ADMUX & 0xE0) | (channel & 0x07);
+    ADC_clearAverage();
+
+    /* Writing ADIF clears it, the first conversion restarts the next ones by itself */
+    ADCSRA |= (1<<ADIF) | (1<<ADATE) | (1<<ADIE) | (1<<ADSC);
+
+    SREG = sreg;
+}
+
+/*
+ * Description:
+ * Stop the conversions, a result still pending is discarded.
+ */
+void ADC_stop(void){
+    ADCSRA &= ~((1<<ADATE) | (1<<ADIE));
+    ADCSRA |= (1<<ADIF);
+}
+
+/*
+ * Description:
+ * Set the size of the moving average.
+ */
+boolean ADC_setWindow(uint8 window){
+    uint8 sreg;
+
+    if((window == 0) || (window > ADC_MAX_WINDOW)){
+        return False;
+    }
+
+    sreg = SREG;
+    cli();
+    g_window = window;
+    ADC_clearAverage();
+    SREG = sreg;
+
+    return True;
+}
+
+/*
+ * Description:
+ * Get the moving average.
+ */
+uint16 ADC_getAverage(void){
+    uint16 average = 0;
+    uint8 sreg;
+
+    sreg = SREG;
+    cli();
+    if(g_count != 0){
+        average = g_sum / g_count;
+    }
+    SREG = sreg;
+
+    return average;
+}
+
+/*
+ * Description:
+ * Set the callback function for the samples.
+ */
+void ADC_setCallBack(void (*a_ptr)(uint16 average)){
+    ADC_CallBack_Ptr = a_ptr;
+}
+
+/* Interrupt Service Routine for the ADC Conversion Complete */
+ISR(ADC_vect){
+    uint16 sample = ADC;
+
+    /* Once the window is full the oldest sample leaves the sum */
+    if(g_count == g_window){
+        g_sum -= g_samples[g_index];
+    }else{
+        g_count++;
+    }
+    g_samples[g_index] = sample;
+    g_sum += sample;
+    g_index = (g_index + 1 == g_window) ? 0 : g_index + 1;
+
+    if(ADC_CallBack_Ptr != NULL_PTR)
+        (*ADC_CallBack_Ptr)(g_sum / g_count);
+}
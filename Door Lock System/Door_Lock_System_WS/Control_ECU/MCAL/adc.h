@@ -0,0 +1,107 @@
+ /******************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.h
+ *
+ * Description: Header file for the AVR ADC driver in free running mode
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define ADC_MAXIMUM_VALUE 1023
+
+/* Largest moving average window, the sum of the samples fits in 16 bits */
+#define ADC_MAX_WINDOW 32
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+// Enumeration for the reference voltage, the REFS1:0 value
+typedef enum{
+	ADC_AREF,
+	ADC_AVCC,
+	ADC_INTERNAL_2_56V = 3
+}ADC_ReferenceVoltage;
+
+// Enumeration for the ADC clock prescaler, the conversion takes 13 ADC clocks
+typedef enum{
+	ADC_PRESCALER_2 = 1,
+	ADC_PRESCALER_4,
+	ADC_PRESCALER_8,
+	ADC_PRESCALER_16,
+	ADC_PRESCALER_32,
+	ADC_PRESCALER_64,
+	ADC_PRESCALER_128
+}ADC_Prescaler;
+
+// Structure to hold the ADC configuration settings
+typedef struct{
+	ADC_ReferenceVoltage ref_volt; // Reference of the full scale
+	ADC_Prescaler prescaler; // ADC clock, between 50 and 200 kHz for the 10 bit resolution
+}ADC_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Function to enable the ADC with the reference and the clock of the configuration.
+ * No conversion is started, the moving average window is set to 1.
+ */
+void ADC_init(const ADC_ConfigType * Config_Ptr);
+
+/*
+ * Description:
+ * Function to stop the conversions and turn the ADC off.
+ */
+void ADC_deinit(void);
+
+/*
+ * Description:
+ * Function to start converting channel (0 to 7, PA0 to PA7) continuously, one
+ * conversion after the other. Each result feeds the moving average from the ISR,
+ * which starts again empty.
+ */
+void ADC_startFreeRunning(uint8 channel);
+
+/*
+ * Description:
+ * Function to stop the conversions, the conversion in progress is dropped.
+ */
+void ADC_stop(void);
+
+/*
+ * Description:
+ * Function to set the number of samples of the moving average, 1 to ADC_MAX_WINDOW.
+ * The average starts again empty. Returns False for a wrong window.
+ */
+boolean ADC_setWindow(uint8 window);
+
+/*
+ * Description:
+ * Function to get the average of the last samples, of the ones received so far
+ * until the window is full. Returns 0 before the first sample.
+ */
+uint16 ADC_getAverage(void);
+
+/*
+ * Description:
+ * Function to set the callback function called from the ISR after each sample,
+ * with the new average.
+ */
+void ADC_setCallBack(void (*a_ptr)(uint16 average));
+
+#endif /* ADC_H_ */
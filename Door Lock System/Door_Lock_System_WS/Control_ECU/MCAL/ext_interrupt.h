@@ -0,0 +1,70 @@
+ /******************************************************************************
+ *
+ * Module: External Interrupts
+ *
+ * File Name: ext_interrupt.h
+ *
+ * Description: Header file for the AVR INT0, INT1 and INT2 driver
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef EXT_INTERRUPT_H_
+#define EXT_INTERRUPT_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+// Enumeration for the external interrupt lines: INT0 on PD2, INT1 on PD3 and INT2 on PB2
+typedef enum{
+	EXT_INT0,
+	EXT_INT1,
+	EXT_INT2
+}ExtInt_IdType;
+
+/*
+ * Enumeration for the event triggering the interrupt.
+ * INT2 only supports the edges. Only a low level on INT0/INT1 or an edge on INT2
+ * wakes the MCU from the power down mode.
+ */
+typedef enum{
+	EXT_INT_LOW_LEVEL,
+	EXT_INT_ANY_CHANGE,
+	EXT_INT_FALLING_EDGE,
+	EXT_INT_RISING_EDGE
+}ExtInt_SenseType;
+
+// Structure to hold the external interrupt configuration settings
+typedef struct{
+	ExtInt_IdType id; // Interrupt line
+	ExtInt_SenseType sense; // Event triggering the interrupt
+}ExtInt_ConfigType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Function to set the pin of the line as input, configure its sense and enable it.
+ * An event seen before the call is discarded.
+ */
+void ExtInt_init(const ExtInt_ConfigType * Config_Ptr);
+
+/*
+ * Description:
+ * Function to disable the interrupt of the line.
+ */
+void ExtInt_deinit(ExtInt_IdType id);
+
+/*
+ * Description:
+ * Function to set the callback function called from the ISR of the line.
+ */
+void ExtInt_setCallBack(ExtInt_IdType id, void (*a_ptr)(void));
+
+#endif /* EXT_INTERRUPT_H_ */
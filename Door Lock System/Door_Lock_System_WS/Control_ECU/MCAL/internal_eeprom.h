@@ -0,0 +1,80 @@
+ /******************************************************************************
+ *
+ * Module: Internal EEPROM
+ *
+ * File Name: internal_eeprom.h
+ *
+ * Description: Header file for the AVR on-chip EEPROM driver
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef INTERNAL_EEPROM_H_
+#define INTERNAL_EEPROM_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define IEEPROM_SIZE 1024
+
+/*
+ * The first IEEPROM_CACHE_SIZE bytes are kept in RAM, the frequently read state
+ * should be placed there so reading it never waits for a write cycle.
+ */
+#define IEEPROM_CACHE_SIZE 16
+
+/* Writes waiting for the EE_RDY interrupt, a power of two up to 128 */
+#define IEEPROM_QUEUE_SIZE 16
+
+#if ((IEEPROM_QUEUE_SIZE & (IEEPROM_QUEUE_SIZE - 1)) != 0) || (IEEPROM_QUEUE_SIZE > 128)
+#error "IEEPROM_QUEUE_SIZE should be a power of two up to 128"
+#endif
+
+#if (IEEPROM_CACHE_SIZE > IEEPROM_SIZE)
+#error "IEEPROM_CACHE_SIZE should not be larger than the EEPROM"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Fill the RAM cache from the EEPROM, before any other function of the driver.
+ */
+void IEEPROM_init(void);
+
+/*
+ * Description :
+ * Read one byte. The cached bytes come from RAM, the others from the queued writes if
+ * one is waiting for the address, otherwise from the EEPROM once no write cycle is running.
+ */
+uint8 IEEPROM_readByte(uint16 u16addr);
+void IEEPROM_readBlock(uint16 u16addr, uint8 *u8data, uint16 u16size);
+
+/*
+ * Description :
+ * Queue one byte to be written by the EE_RDY interrupt and return, about 8.5 ms per byte.
+ * A byte that already holds the value is not written again.
+ * Returns False if the queue is full.
+ */
+boolean IEEPROM_writeByte(uint16 u16addr, uint8 u8data);
+
+/*
+ * Description :
+ * Queue u8size bytes, nothing is queued if they do not all fit.
+ * Returns False if the queue is full.
+ */
+boolean IEEPROM_writeBlock(uint16 u16addr, const uint8 *u8data, uint8 u8size);
+
+/*
+ * Description :
+ * Returns True when every queued byte has been written.
+ */
+boolean IEEPROM_isIdle(void);
+
+#endif /* INTERNAL_EEPROM_H_ */
@@ -14,14 +14,55 @@
 #include "gpio.h"        // Include GPIO header file for pin operations
 #include "timer0_pwm.h"         // Include PWM header file for function prototypes
 
+// Mode and clock given to PWM_Timer0_init, fast PWM at F_CPU/8 by default
+static PWM_Timer0_ConfigType g_config = {PWM_FAST, PWM_PRESCALER_8};
+
+void PWM_Timer0_init(const PWM_Timer0_ConfigType * Config_Ptr){
+
+    g_config = *Config_Ptr;
+
+    PWM_Timer0_Stop(); // Stopped until the first PWM_Timer0_Start
+
+    GPIO_SETUP_PIN_DIRECTION(PORTB_ID, PIN3_ID, PIN_OUTPUT); // Configure pin as output
+}
+
 void PWM_Timer0_Start(uint8 duty_cycle){
 
+    uint8 mode;
+
+    // Already running: only the duty cycle, restarting the counter would cut the current period
+    if((TCCR0 & 0x07) != 0){
+        PWM_Timer0_setDutyCycle(duty_cycle);
+        return;
+    }
+
     TCNT0 = 0;  // Initialize Timer0 counter value
 
+    // Timer0 is in normal mode while it is stopped, so OCR0 is written at once and not at the next TOP
     OCR0  = duty_cycle;  // Set duty cycle using Output Compare Register
 
-    GPIO_setupPinDirection(PORTB_ID, PIN3_ID, PIN_OUTPUT); // Configure pin as output
+    mode = (g_config.mode == PWM_FAST) ? ((1<<WGM00) | (1<<WGM01)) : (1<<WGM00);
+
+    // Configure Timer0 mode, non-inverting output (not connected for 0%), and set prescaler
+    TCCR0 = mode | ((duty_cycle != 0) ? (1<<COM01) : 0) | (g_config.prescaler & 0x07);
+}
+
+void PWM_Timer0_setDutyCycle(uint8 duty_cycle){
+
+    // OCR0 is double buffered in the PWM modes, the new value is used from the next period
+    OCR0 = duty_cycle;
+
+    // Fast PWM still outputs one count high at OCR0 = 0, OC0 is disconnected to keep the pin low
+    if(duty_cycle == 0){
+        TCCR0 &= ~((1<<COM01) | (1<<COM00));
+    }else{
+        TCCR0 |= (1<<COM01);
+    }
+}
+
+void PWM_Timer0_Stop(void){
 
-    // Configure Timer0 for Fast PWM mode, non-inverting mode, and set prescaler
-    TCCR0 = (1<<WGM00) | (1<<WGM01) | (1<<COM01) | (1<<CS01);
+    // No clock source, the counter stops and draws no power, and OC0 disconnected with the pin low
+    TCCR0 = 0;
+    GPIO_WRITE_PIN(PORTB_ID, PIN3_ID, LOGIC_LOW);
 }
@@ -14,7 +14,38 @@
 
 #include "../LIB/std_types.h"  // Include standard data types header file
 
-// Function to start PWM using Timer0
+// Enumeration for the Timer0 clock prescaler, the PWM frequency is F_CPU / prescaler / 256 in fast mode
+typedef enum{
+    PWM_NO_CLK,
+    PWM_NO_PRESCALER,
+    PWM_PRESCALER_8,
+    PWM_PRESCALER_64,
+    PWM_PRESCALER_256,
+    PWM_PRESCALER_1024
+}PWM_Timer0_Prescaler;
+
+// Enumeration for the PWM mode, phase correct counts up and down so its frequency is halved
+typedef enum{
+    PWM_FAST,
+    PWM_PHASE_CORRECT
+}PWM_Timer0_Mode;
+
+// Structure to hold the PWM configuration settings
+typedef struct{
+    PWM_Timer0_Mode mode; // Fast or phase correct PWM
+    PWM_Timer0_Prescaler prescaler; // Clock of the counter, sets the PWM frequency
+}PWM_Timer0_ConfigType;
+
+// Function to set the PWM mode and frequency and the OC0 pin (PB3) as output, Timer0 is left stopped
+void PWM_Timer0_init(const PWM_Timer0_ConfigType * Config_Ptr);
+
+// Function to start PWM using Timer0, if it already runs only the duty cycle is updated
 void PWM_Timer0_Start(uint8 duty_cycle);
 
+// Function to change the duty cycle at the end of the current period, the counter keeps running
+void PWM_Timer0_setDutyCycle(uint8 duty_cycle);
+
+// Function to stop the clock of Timer0 and hold OC0 low
+void PWM_Timer0_Stop(void);
+
 #endif
@@ -17,6 +17,7 @@
 
 /* Define a pointer to function that will hold the address of the callback function */
 void (*Timer1_CallBack_Ptr)(void) = NULL_PTR;
+void (*Timer1_CaptureCallBack_Ptr)(void) = NULL_PTR;
 
 /*
  * Description:
@@ -31,7 +32,7 @@ void Timer1_init(const Timer1_ConfigType * Config_Ptr){
 
     /* Configure Timer1 mode (WGM10, WGM11 bits) */
     TCCR1A &= 0xFC;
-    TCCR1A |= (Config_Ptr -> mode) & 0x04;
+    TCCR1A |= (Config_Ptr -> mode) & 0x03;
 
     /* Configure Timer1 mode (WGM12, WGM13 bits) and Prescaler (CS10, CS11, CS12 bits) */
     TCCR1B &= 0xE7;
@@ -39,8 +40,13 @@ void Timer1_init(const Timer1_ConfigType * Config_Ptr){
     TCCR1B &= 0xF8;
     TCCR1B |= (Config_Ptr -> prescaler) & 0x07;
 
-    /* Enable the Timer1 compare interrupt and overflow interrupt */
-    TIMSK |= (1<<OCIE1A) | (1<<TOIE1);
+    /* Enable only the interrupt of the mode, in compare mode the counter never overflows
+     * and in normal mode OCR1A is not the period */
+    TIMSK &= ~((1<<OCIE1A) | (1<<TOIE1));
+    if((Config_Ptr -> mode) == COMPARE)
+        TIMSK |= (1<<OCIE1A);
+    else
+        TIMSK |= (1<<TOIE1);
 }
 
 /*
@@ -49,7 +55,7 @@ void Timer1_init(const Timer1_ConfigType * Config_Ptr){
  */
 void Timer1_deinit(void){
     TCCR1B = 0x00;
-    TIMSK &= 0xEB;
+    TIMSK &= ~((1<<OCIE1A) | (1<<TOIE1) | (1<<TICIE1));
 }
 
 /*
@@ -60,12 +66,53 @@ void Timer1_setCallBack(void (*a_ptr)(void)){
     Timer1_CallBack_Ptr = a_ptr;
 }
 
+/*
+ * Description:
+ * Enable the input capture interrupt on the given edge of ICP1.
+ */
+void Timer1_enableCapture(Timer1_CaptureEdge edge){
+    /* Noise canceler on, the edge is accepted after 4 equal samples */
+    TCCR1B |= (1<<ICNC1);
+    if(edge == CAPTURE_RISING_EDGE)
+        TCCR1B |= (1<<ICES1);
+    else
+        TCCR1B &= ~(1<<ICES1);
+
+    /* Changing the edge may raise the flag, clear it before enabling */
+    TIFR = (1<<ICF1);
+    TIMSK |= (1<<TICIE1);
+}
+
+/*
+ * Description:
+ * Disable the input capture interrupt.
+ */
+void Timer1_disableCapture(void){
+    TIMSK &= ~(1<<TICIE1);
+}
+
+/*
+ * Description:
+ * Set the callback function for the input capture.
+ */
+void Timer1_setCaptureCallBack(void (*a_ptr)(void)){
+    Timer1_CaptureCallBack_Ptr = a_ptr;
+}
+
 /* Interrupt Service Routine for Timer1 Compare Match A */
 ISR(TIMER1_COMPA_vect){
-    (*Timer1_CallBack_Ptr)();
+    if(Timer1_CallBack_Ptr != NULL_PTR)
+        (*Timer1_CallBack_Ptr)();
 }
 
 /* Interrupt Service Routine for Timer1 Overflow */
 ISR(TIMER1_OVF_vect){
-    (*Timer1_CallBack_Ptr)();
+    if(Timer1_CallBack_Ptr != NULL_PTR)
+        (*Timer1_CallBack_Ptr)();
+}
+
+/* Interrupt Service Routine for Timer1 Input Capture */
+ISR(TIMER1_CAPT_vect){
+    if(Timer1_CaptureCallBack_Ptr != NULL_PTR)
+        (*Timer1_CaptureCallBack_Ptr)();
 }
@@ -30,6 +30,12 @@ typedef enum{
 	COMPARE = 4
 }Timer1_Mode;
 
+// Enumeration for the edge of ICP1 (PD6) captured in ICR1
+typedef enum{
+	CAPTURE_FALLING_EDGE,
+	CAPTURE_RISING_EDGE
+}Timer1_CaptureEdge;
+
 // Structure to hold Timer1 configuration settings
 typedef struct{
 	uint16 initial_value; // Initial value of the counter
@@ -61,4 +67,23 @@ void Timer1_deinit(void);
  */
 void Timer1_setCallBack(void (*a_ptr)(void));
 
+/*
+ * Description:
+ * Function to enable the input capture interrupt on edge of ICP1, with the noise canceler.
+ * It runs beside the compare or overflow interrupt, in compare mode TOP is OCR1A so ICR1 is free.
+ */
+void Timer1_enableCapture(Timer1_CaptureEdge edge);
+
+/*
+ * Description:
+ * Function to disable the input capture interrupt.
+ */
+void Timer1_disableCapture(void);
+
+/*
+ * Description:
+ * Function to set the callback function called on each capture, ICR1 holds the counter at the edge.
+ */
+void Timer1_setCaptureCallBack(void (*a_ptr)(void));
+
 #endif /* TIMER1_H_ */
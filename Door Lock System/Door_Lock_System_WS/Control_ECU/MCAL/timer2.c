@@ -0,0 +1,40 @@
+ /******************************************************************************
+ *
+ * Module: TIMER2
+ *
+ * File Name: timer2.c
+ *
+ * Description: Source file for the AVR TIMER2 square wave driver
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "timer2.h"
+#include "gpio.h"
+#include "avr/io.h"
+
+/*
+ * Description:
+ * Start the square wave on OC2 with the specified configurations.
+ */
+void Timer2_startSquareWave(const Timer2_ConfigType * Config_Ptr){
+    GPIO_SETUP_PIN_DIRECTION(PORTD_ID, PIN7_ID, PIN_OUTPUT);
+
+    /* Stopped while the compare value changes, a new TOP below the counter would wrap at 255 */
+    TCCR2 = 0x00;
+    TCNT2 = 0;
+    OCR2 = Config_Ptr -> compare_value;
+
+    /* Compare mode (WGM21), toggle OC2 on compare match (COM20) and prescaler (CS22:0) */
+    TCCR2 = (1<<WGM21) | (1<<COM20) | ((Config_Ptr -> prescaler) & 0x07);
+}
+
+/*
+ * Description:
+ * Stop Timer2, OC2 is disconnected and the pin is left low.
+ */
+void Timer2_stop(void){
+    TCCR2 = 0x00;
+    GPIO_WRITE_PIN(PORTD_ID, PIN7_ID, LOGIC_LOW);
+}
@@ -0,0 +1,52 @@
+ /******************************************************************************
+ *
+ * Module: TIMER2
+ *
+ * File Name: timer2.h
+ *
+ * Description: Header file for the AVR TIMER2 square wave driver
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef TIMER2_H_
+#define TIMER2_H_
+
+#include "../LIB/std_types.h"
+
+// Enumeration for different prescaler values, Timer2 also has /32 and /128
+typedef enum{
+	TIMER2_NO_CLK,
+	TIMER2_NO_PRESCALER,
+	TIMER2_PRESCALER_8,
+	TIMER2_PRESCALER_32,
+	TIMER2_PRESCALER_64,
+	TIMER2_PRESCALER_128,
+	TIMER2_PRESCALER_256,
+	TIMER2_PRESCALER_1024
+}Timer2_Prescaler;
+
+// Structure to hold Timer2 configuration settings
+typedef struct{
+	uint8 compare_value; // TOP of the counter, half a period of the wave
+	Timer2_Prescaler prescaler; // Prescaler for clock division
+}Timer2_ConfigType;
+
+// Function prototypes for Timer2 driver
+
+/*
+ * Description:
+ * Function to output a square wave of F_CPU / (2 * prescaler * (1 + compare_value)) on OC2 (PD7).
+ * Timer2 runs in compare mode and toggles OC2 in hardware, no interrupt is used.
+ * A running wave changes at once.
+ */
+void Timer2_startSquareWave(const Timer2_ConfigType * Config_Ptr);
+
+/*
+ * Description:
+ * Function to stop the clock of Timer2 and hold OC2 low.
+ */
+void Timer2_stop(void);
+
+#endif /* TIMER2_H_ */
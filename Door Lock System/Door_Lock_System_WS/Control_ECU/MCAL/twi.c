@@ -13,6 +13,34 @@
 #include "twi.h"
 #include "../LIB/common_macros.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "gpio.h"
+
+/* Queue of transactions served by the TWI ISR */
+static TWI_TransactionType g_queue[TWI_QUEUE_SIZE];
+static volatile uint8 g_queueHead = 0; /* Next free place */
+static volatile uint8 g_queueTail = 0; /* Running transaction */
+static volatile uint8 g_queueCount = 0;
+static volatile boolean g_running = False; /* The ISR owns the bus */
+
+/* Progress of the running transaction */
+static volatile uint8 g_addressIndex; /* Address bytes already sent */
+static volatile uint8 g_dataIndex; /* Data bytes already sent or received */
+static volatile uint16 g_retries; /* Address NACKs of the running transaction */
+
+/* Set when a blocking function gave up waiting, cleared by the next TWI_start or TWI_submit */
+static volatile boolean g_timedOut = False;
+
+/* Millisecond clock of the deadlines, NULL_PTR until TWI_setTimeSource */
+static uint32 (*g_getMs)(void) = NULL_PTR;
+
+static void TWI_startNext(uint8 control);
+static void TWI_finish(uint8 status);
+static void TWI_waitForFlag(void);
+static uint32 TWI_now(void);
+static boolean TWI_isExpired(uint32 start, uint32 *passes, uint16 timeout_ms);
+static void TWI_recoverBus(void);
 
 void TWI_init(const TWI_ConfigType * Config_Ptr)
 {
@@ -25,8 +53,17 @@ void TWI_init(const TWI_ConfigType * Config_Ptr)
     TWCR = (1<<TWEN); /* enable TWI */
 }
 
+void TWI_setTimeSource(uint32 (*a_ptr)(void))
+{
+    g_getMs = a_ptr;
+}
+
 void TWI_start(void)
 {
+    /* Let the queued transactions finish first, they own the bus */
+    TWI_waitIdle();
+    g_timedOut = False;
+
     /* 
 	 * Clear the TWINT flag before sending the start bit TWINT=1
 	 * send the start bit by TWSTA=1
@@ -35,7 +72,7 @@ void TWI_start(void)
     TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
     
     /* Wait for TWINT flag set in TWCR Register (start bit is send successfully) */
-    while(BIT_IS_CLEAR(TWCR,TWINT));
+    TWI_waitForFlag();
 }
 
 void TWI_stop(void)
@@ -58,7 +95,7 @@ void TWI_writeByte(uint8 data)
 	 */ 
     TWCR = (1 << TWINT) | (1 << TWEN);
     /* Wait for TWINT flag set in TWCR Register(data is send successfully) */
-    while(BIT_IS_CLEAR(TWCR,TWINT));
+    TWI_waitForFlag();
 }
 
 uint8 TWI_readByteWithACK(void)
@@ -70,7 +107,7 @@ uint8 TWI_readByteWithACK(void)
 	 */ 
     TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
     /* Wait for TWINT flag set in TWCR Register (data received successfully) */
-    while(BIT_IS_CLEAR(TWCR,TWINT));
+    TWI_waitForFlag();
     /* Read Data */
     return TWDR;
 }
@@ -83,7 +120,7 @@ uint8 TWI_readByteWithNACK(void)
 	 */
     TWCR = (1 << TWINT) | (1 << TWEN);
     /* Wait for TWINT flag set in TWCR Register (data received successfully) */
-    while(BIT_IS_CLEAR(TWCR,TWINT));
+    TWI_waitForFlag();
     /* Read Data */
     return TWDR;
 }
@@ -91,7 +128,302 @@ uint8 TWI_readByteWithNACK(void)
 uint8 TWI_getStatus(void)
 {
     uint8 status;
+
+    if(g_timedOut)
+        return TWI_TIMEOUT;
+
     /* masking to eliminate first 3 bits and get the last 5 bits (status bits) */
     status = TWSR & 0xF8;
     return status;
 }
+
+boolean TWI_submit(const TWI_TransactionType *transaction)
+{
+    uint8 sreg;
+
+    if((transaction->address_size > 2) || ((transaction->direction == TWI_READ) && (transaction->length == 0)))
+        return False;
+
+    /* The ISR also changes the queue, so keep it out while the queue is updated */
+    sreg = SREG;
+    cli();
+
+    if(g_queueCount == TWI_QUEUE_SIZE)
+    {
+        SREG = sreg;
+        return False;
+    }
+
+    g_queue[g_queueHead] = *transaction;
+    g_queueHead = (g_queueHead + 1) % TWI_QUEUE_SIZE;
+    g_queueCount++;
+    g_timedOut = False; /* The timeout was for the blocking transaction before */
+
+    /* Bus is free, send the start bit and let the ISR do the rest */
+    if(!g_running)
+    {
+        g_running = True;
+        TWI_startNext(0);
+    }
+
+    SREG = sreg;
+    return True;
+}
+
+boolean TWI_isIdle(void)
+{
+    return !g_running;
+}
+
+boolean TWI_waitIdle(void)
+{
+    uint32 start = TWI_now();
+    uint32 passes = 0;
+    void (*callback)(uint8);
+    uint8 sreg;
+
+    while(g_running)
+    {
+        if(TWI_isExpired(start, &passes, TWI_QUEUE_TIMEOUT_MS))
+        {
+            /* The ISR never came back, drop the whole queue */
+            sreg = SREG;
+            cli();
+            TWCR = 0;
+            while(g_queueCount != 0)
+            {
+                callback = g_queue[g_queueTail].callback;
+                g_queueTail = (g_queueTail + 1) % TWI_QUEUE_SIZE;
+                g_queueCount--;
+                if(callback != NULL_PTR)
+                {
+                    callback(TWI_TIMEOUT);
+                }
+            }
+            g_running = False;
+            SREG = sreg;
+            TWI_recoverBus();
+            return False;
+        }
+    }
+
+    return True;
+}
+
+/*
+ * Description :
+ * Wait for the TWINT flag until the deadline, recover the bus if it never comes.
+ */
+static void TWI_waitForFlag(void)
+{
+    uint32 start = TWI_now();
+    uint32 passes = 0;
+
+    while(BIT_IS_CLEAR(TWCR,TWINT))
+    {
+        if(TWI_isExpired(start, &passes, TWI_BYTE_TIMEOUT_MS))
+        {
+            g_timedOut = True;
+            TWI_recoverBus();
+            return;
+        }
+    }
+}
+
+/*
+ * Description :
+ * Returns the time source milliseconds, 0 without a time source.
+ */
+static uint32 TWI_now(void)
+{
+    return (g_getMs != NULL_PTR) ? g_getMs() : 0;
+}
+
+/*
+ * Description :
+ * Returns True once more than timeout_ms went by since start, taken from TWI_now.
+ * The tick only runs with the interrupts on, so without a time source or with the
+ * interrupts off each call waits TWI_POLL_INTERVAL_US and counts one pass in passes.
+ * The loop around it makes these waits longer than counted, they are only a fallback.
+ */
+static boolean TWI_isExpired(uint32 start, uint32 *passes, uint16 timeout_ms)
+{
+    if((g_getMs != NULL_PTR) && BIT_IS_SET(SREG, 7))
+    {
+        /* More than timeout_ms, the tick may move just after start was taken */
+        return (g_getMs() - start) > timeout_ms;
+    }
+
+    _delay_us(TWI_POLL_INTERVAL_US);
+    (*passes)++;
+    return *passes > (timeout_ms * 1000UL / TWI_POLL_INTERVAL_US);
+}
+
+/*
+ * Description :
+ * Standard I2C bus clear: with the module disabled, clock SCL until the slave that holds
+ * SDA low releases it (9 clocks at most), then send a STOP and enable the module again.
+ * Lines are driven low as outputs and released as inputs to act as open drain.
+ */
+static void TWI_recoverBus(void)
+{
+    uint8 i;
+
+    TWCR = 0; /* Give the pins back to the port */
+
+    GPIO_writePin(TWI_PORT_ID, TWI_SCL_PIN_ID, LOGIC_LOW);
+    GPIO_writePin(TWI_PORT_ID, TWI_SDA_PIN_ID, LOGIC_LOW);
+    GPIO_setupPinDirection(TWI_PORT_ID, TWI_SDA_PIN_ID, PIN_INPUT);
+
+    for(i = 0; (i < 9) && (GPIO_readPin(TWI_PORT_ID, TWI_SDA_PIN_ID) == LOGIC_LOW); i++)
+    {
+        GPIO_setupPinDirection(TWI_PORT_ID, TWI_SCL_PIN_ID, PIN_OUTPUT);
+        _delay_us(5);
+        GPIO_setupPinDirection(TWI_PORT_ID, TWI_SCL_PIN_ID, PIN_INPUT);
+        _delay_us(5);
+    }
+
+    /* STOP condition: SDA goes high while SCL is high */
+    GPIO_setupPinDirection(TWI_PORT_ID, TWI_SCL_PIN_ID, PIN_OUTPUT);
+    GPIO_setupPinDirection(TWI_PORT_ID, TWI_SDA_PIN_ID, PIN_OUTPUT);
+    _delay_us(5);
+    GPIO_setupPinDirection(TWI_PORT_ID, TWI_SCL_PIN_ID, PIN_INPUT);
+    _delay_us(5);
+    GPIO_setupPinDirection(TWI_PORT_ID, TWI_SDA_PIN_ID, PIN_INPUT);
+    _delay_us(5);
+
+    TWCR = (1 << TWEN); /* TWBR is kept, so the bit rate is the same */
+}
+
+/*
+ * Description :
+ * Reset the progress counters and send a start bit for the transaction at the queue tail.
+ * control holds extra TWCR bits, TWSTO to stop the previous transaction in the same write.
+ */
+static void TWI_startNext(uint8 control)
+{
+    g_addressIndex = 0;
+    g_dataIndex = 0;
+    g_retries = 0;
+    TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE) | control;
+}
+
+/*
+ * Description :
+ * Stop the running transaction, report its status and start the next one if any.
+ */
+static void TWI_finish(uint8 status)
+{
+    void (*callback)(uint8) = g_queue[g_queueTail].callback;
+
+    g_queueTail = (g_queueTail + 1) % TWI_QUEUE_SIZE;
+    g_queueCount--;
+
+    /* The callback may queue a follow-up transaction, it is started below */
+    if(callback != NULL_PTR)
+    {
+        callback(status);
+    }
+
+    if(g_queueCount != 0)
+    {
+        /* Stop and start again in one write, the hardware sends STOP then START */
+        TWI_startNext(1 << TWSTO);
+    }
+    else
+    {
+        /* Stop and leave the interrupt disabled so the blocking functions can be used */
+        TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+        g_running = False;
+    }
+}
+
+ISR(TWI_vect)
+{
+    TWI_TransactionType *transaction = &g_queue[g_queueTail];
+    uint8 status = TWSR & 0xF8; /* Not TWI_getStatus, a timeout of the blocking functions does not concern the queue */
+
+    switch(status)
+    {
+    case TWI_START:
+        /* Address phase always starts with a write, unless there is no address to send */
+        if((transaction->address_size == 0) && (transaction->direction == TWI_READ))
+            TWDR = transaction->device | 1;
+        else
+            TWDR = transaction->device;
+        TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+        break;
+
+    case TWI_REP_START:
+        /* Data phase of a read */
+        TWDR = transaction->device | 1;
+        TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+        break;
+
+    case TWI_MT_SLA_W_ACK:
+    case TWI_MT_DATA_ACK:
+        if(g_addressIndex < transaction->address_size)
+        {
+            /* Register or memory address, high byte first */
+            if((transaction->address_size - g_addressIndex) == 2)
+                TWDR = (uint8)(transaction->address >> 8);
+            else
+                TWDR = (uint8)(transaction->address);
+            g_addressIndex++;
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+        }
+        else if(transaction->direction == TWI_READ)
+        {
+            /* Address is set, turn the bus around with a repeated start */
+            TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+        }
+        else if(g_dataIndex < transaction->length)
+        {
+            TWDR = transaction->buffer[g_dataIndex++];
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+        }
+        else
+        {
+            TWI_finish(TWI_TRANSACTION_OK);
+        }
+        break;
+
+    case TWI_MT_SLA_R_ACK:
+        /* ACK all the bytes except the last one */
+        if(transaction->length > 1)
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE) | (1 << TWEA);
+        else
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+        break;
+
+    case TWI_MR_DATA_ACK:
+        transaction->buffer[g_dataIndex++] = TWDR;
+        if((transaction->length - g_dataIndex) > 1)
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE) | (1 << TWEA);
+        else
+            TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+        break;
+
+    case TWI_MR_DATA_NACK:
+        transaction->buffer[g_dataIndex] = TWDR;
+        TWI_finish(TWI_TRANSACTION_OK);
+        break;
+
+    case TWI_MT_SLA_W_NACK:
+        /* Slave busy (e.g. EEPROM write cycle), try again from the start bit */
+        if(g_retries < TWI_MAX_ADDRESS_RETRIES)
+        {
+            g_retries++;
+            g_addressIndex = 0;
+            TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+            break;
+        }
+        TWI_finish(status);
+        break;
+
+    default:
+        /* Data NACK, read address NACK, arbitration lost or bus error */
+        TWI_finish(status);
+        break;
+    }
+}
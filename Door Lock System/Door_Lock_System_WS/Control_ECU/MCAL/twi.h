@@ -28,6 +28,27 @@ typedef struct{
 	uint8 address;
 	TWI_BaudRate bit_rate;
 }TWI_ConfigType;
+
+typedef enum{
+	TWI_WRITE,
+	TWI_READ
+}TWI_DirectionType;
+
+/*
+ * Description of one queued transaction:
+ * START, SLA+W, address_size register/memory address bytes (high byte first), then
+ * either the data bytes for a write, or a repeated START, SLA+R and the data bytes for a read.
+ * The callback is called from the TWI ISR with TWI_TRANSACTION_OK or the TWSR status that failed.
+ */
+typedef struct{
+	uint8 device; /* Slave address with R/W bit = 0 */
+	uint16 address; /* Register or memory address inside the slave */
+	uint8 address_size; /* Number of address bytes to send: 0, 1 or 2 */
+	uint8 *buffer; /* Data to write or place for the read data */
+	uint8 length; /* Number of data bytes */
+	TWI_DirectionType direction;
+	void (*callback)(uint8 status);
+}TWI_TransactionType;
 /*******************************************************************************
  *                      Preprocessor Macros                                    *
  *******************************************************************************/
@@ -36,14 +57,51 @@ typedef struct{
 #define TWI_START         0x08 /* start has been sent */
 #define TWI_REP_START     0x10 /* repeated start */
 #define TWI_MT_SLA_W_ACK  0x18 /* Master transmit ( slave address + Write request ) to slave + ACK received from slave. */
+#define TWI_MT_SLA_W_NACK 0x20 /* Master transmit ( slave address + Write request ) to slave + NACK received from slave. */
 #define TWI_MT_SLA_R_ACK  0x40 /* Master transmit ( slave address + Read request ) to slave + ACK received from slave. */
 #define TWI_MT_DATA_ACK   0x28 /* Master transmit data and ACK has been received from Slave. */
 #define TWI_MR_DATA_ACK   0x50 /* Master received data and send ACK to slave. */
 #define TWI_MR_DATA_NACK  0x58 /* Master received data but doesn't send ACK to slave. */
 
+/* Status passed to a transaction callback when it completed, not a TWSR status value */
+#define TWI_TRANSACTION_OK 0x01
+
+/* Status reported when TWINT did not come in time and the bus was recovered, not a TWSR status value */
+#define TWI_TIMEOUT 0x02
+
+/*
+ * Deadlines, measured on the time source given to TWI_setTimeSource.
+ * A byte takes ~25 us at 400 kHz, the queue timeout covers a full queue of EEPROM page writes.
+ * Without the time source the wait is counted in TWI_POLL_INTERVAL_US delays instead.
+ */
+#define TWI_BYTE_TIMEOUT_MS 1
+#define TWI_QUEUE_TIMEOUT_MS 60
+#define TWI_POLL_INTERVAL_US 1
+
+/* TWI pins, driven by hand during the bus recovery */
+#define TWI_PORT_ID PORTC_ID
+#define TWI_SCL_PIN_ID PIN0_ID
+#define TWI_SDA_PIN_ID PIN1_ID
+
+/* Number of transactions that can wait in the queue */
+#define TWI_QUEUE_SIZE 4
+
+/*
+ * Number of times a transaction is started again when the slave does not acknowledge
+ * its address, this covers a 24Cxx that is still busy with a write cycle (~50 us per try).
+ */
+#define TWI_MAX_ADDRESS_RETRIES 400
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
+
+/*
+ * Description :
+ * The blocking functions wait for TWINT at most TWI_BYTE_TIMEOUT_MS. On expiry they clock
+ * SCL up to 9 times to free SDA, send a STOP and re-enable the module, then
+ * TWI_getStatus returns TWI_TIMEOUT until the next TWI_start or TWI_submit.
+ */
 void TWI_init(const TWI_ConfigType * Config_Ptr);
 void TWI_start(void);
 void TWI_stop(void);
@@ -52,5 +110,34 @@ uint8 TWI_readByteWithACK(void);
 uint8 TWI_readByteWithNACK(void);
 uint8 TWI_getStatus(void);
 
+/*
+ * Description :
+ * Set the millisecond clock of the deadlines, e.g. SwTimer_getMs. It is only read while
+ * the interrupts are on, the wait is counted in polling delays otherwise.
+ */
+void TWI_setTimeSource(uint32 (*a_ptr)(void));
+
+/*
+ * Description :
+ * Copy the transaction to the queue and start it from the TWI ISR if the bus is free.
+ * Returns True if queued, False if the queue is full or the transaction is not valid.
+ * The blocking functions above must not be used while the queue is not empty.
+ */
+boolean TWI_submit(const TWI_TransactionType *transaction);
+
+/*
+ * Description :
+ * Returns True when no queued transaction is running or waiting.
+ */
+boolean TWI_isIdle(void);
+
+/*
+ * Description :
+ * Wait until the queue is empty, at most TWI_QUEUE_TIMEOUT_MS. On expiry every queued
+ * transaction is dropped with a TWI_TIMEOUT callback and the bus is recovered.
+ * Returns False if the queue had to be dropped.
+ */
+boolean TWI_waitIdle(void);
+
 
 #endif /* TWI_H_ */
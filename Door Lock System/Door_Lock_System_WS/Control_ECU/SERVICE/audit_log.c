@@ -0,0 +1,251 @@
+ /******************************************************************************
+ *
+ * Module: Audit Log
+ *
+ * File Name: audit_log.c
+ *
+ * Description: Source file for the append only access audit log kept in a
+ *              circular region of the external EEPROM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "audit_log.h"
+#include "../MCAL/twi.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* RAM copy of the page that holds the next record */
+static AuditLog_RecordType g_page[AUDIT_LOG_RECORDS_PER_PAGE];
+
+static uint16 g_head = 0; /* Slot of the next record */
+static uint16 g_sequence = 0; /* Sequence number of the next record */
+static uint16 g_count = 0;
+
+/* Changed from the TWI ISR through the write callback */
+static volatile uint8 g_pending = 0; /* Records in the RAM page not queued for writing yet */
+static volatile boolean g_writing = False; /* A page write is queued on the TWI engine */
+static volatile uint8 g_written = 0; /* Records in the queued page write */
+static volatile uint8 g_retries = 0; /* Failed tries of the records in g_written */
+
+static uint32 (*g_timeSource)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 AuditLog_readSequence(uint16 slot, uint16 *sequence);
+static void AuditLog_flush(void);
+static void AuditLog_writeDone(uint8 status);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 AuditLog_init(void)
+{
+	uint16 first;
+	uint16 sequence;
+	uint16 newest;
+	uint16 slot;
+	uint8 status;
+
+	g_head = 0;
+	g_sequence = 0;
+	g_count = 0;
+	g_pending = 0;
+	g_writing = False;
+	g_retries = 0;
+
+	status = AuditLog_readSequence(0, &first);
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+	if(first == AUDIT_LOG_ERASED_SEQUENCE)
+	{
+		return SUCCESS; /* Nothing logged yet */
+	}
+
+	/*
+	 * Slot 0 belongs to the current lap, the slots after it continue its numbering up to
+	 * the newest record. The newest one is the last slot that does: a record lost by a failed
+	 * write keeps what the slot held before, so the numbering may break before it.
+	 */
+	newest = 0;
+	for(slot = 1; slot < AUDIT_LOG_RECORDS; slot++)
+	{
+		status = AuditLog_readSequence(slot, &sequence);
+		if(status != SUCCESS)
+		{
+			return status;
+		}
+
+		if(sequence == ((first + slot) & AUDIT_LOG_SEQUENCE_MASK))
+		{
+			newest = slot;
+		}
+	}
+
+	g_head = (newest + 1) % AUDIT_LOG_RECORDS;
+	g_sequence = (first + newest + 1) & AUDIT_LOG_SEQUENCE_MASK;
+
+	/* The log is full once the slot after the newest one holds an older record */
+	g_count = AUDIT_LOG_RECORDS;
+	if(g_head != 0)
+	{
+		status = AuditLog_readSequence(g_head, &sequence);
+		if(status != SUCCESS)
+		{
+			return status;
+		}
+		if(sequence == AUDIT_LOG_ERASED_SEQUENCE)
+		{
+			g_count = g_head;
+		}
+	}
+
+	return SUCCESS;
+}
+
+void AuditLog_setTimeSource(uint32 (*a_ptr)(void))
+{
+	g_timeSource = a_ptr;
+}
+
+void AuditLog_append(AuditLog_EventType event, uint8 attempts)
+{
+	AuditLog_RecordType *record;
+	uint8 sreg;
+
+	/* The RAM page is about to be reused, the previous page should be written first */
+	if(((g_head % AUDIT_LOG_RECORDS_PER_PAGE) == 0) && (g_writing || (g_pending != 0)))
+	{
+		AuditLog_flush();
+		TWI_waitIdle();
+
+		/* Whatever could not be queued is dropped */
+		sreg = SREG;
+		cli();
+		g_pending = 0;
+		g_retries = 0;
+		SREG = sreg;
+	}
+
+	/* The slot is after the ones being written, the running write does not read it */
+	record = &g_page[g_head % AUDIT_LOG_RECORDS_PER_PAGE];
+	record->sequence = g_sequence;
+	record->event = (uint8)event;
+	record->attempts = attempts;
+	record->timestamp = (g_timeSource != NULL_PTR) ? (*g_timeSource)() : 0;
+
+	sreg = SREG;
+	cli();
+	g_head = (g_head + 1) % AUDIT_LOG_RECORDS;
+	g_sequence = (g_sequence + 1) & AUDIT_LOG_SEQUENCE_MASK;
+	if(g_count < AUDIT_LOG_RECORDS)
+	{
+		g_count++;
+	}
+	g_pending++;
+	SREG = sreg;
+
+	AuditLog_flush();
+}
+
+uint16 AuditLog_getCount(void)
+{
+	return g_count;
+}
+
+uint8 AuditLog_read(uint16 index, AuditLog_RecordType *record)
+{
+	uint16 slot;
+
+	if(index >= g_count)
+	{
+		return ERROR;
+	}
+
+	/* Until the log is full the oldest record is in slot 0, then it is the next one to be replaced */
+	slot = ((g_count < AUDIT_LOG_RECORDS) ? 0 : g_head) + index;
+	slot %= AUDIT_LOG_RECORDS;
+
+	/* The blocking read waits for the queued writes */
+	AuditLog_flush();
+	return EEPROM_readBlock(AUDIT_LOG_ADDRESS + (uint32)slot * AUDIT_LOG_RECORD_SIZE, (uint8 *)record, sizeof(*record));
+}
+
+/*
+ * Description :
+ * Read the sequence number of the record in a slot.
+ */
+static uint8 AuditLog_readSequence(uint16 slot, uint16 *sequence)
+{
+	return EEPROM_readBlock(AUDIT_LOG_ADDRESS + (uint32)slot * AUDIT_LOG_RECORD_SIZE, (uint8 *)sequence, sizeof(*sequence));
+}
+
+/*
+ * Description :
+ * Queue one page write with all the pending records, unless a write is already queued.
+ * Called from the main code and from the TWI ISR.
+ */
+static void AuditLog_flush(void)
+{
+	uint16 first;
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if(!g_writing && (g_pending != 0))
+	{
+		/* The pending records are the last ones added, all in the RAM page */
+		first = (g_head + AUDIT_LOG_RECORDS - g_pending) % AUDIT_LOG_RECORDS;
+
+		if(EEPROM_writePageAsync(AUDIT_LOG_ADDRESS + (uint32)first * AUDIT_LOG_RECORD_SIZE,
+				(const uint8 *)&g_page[first % AUDIT_LOG_RECORDS_PER_PAGE],
+				g_pending * AUDIT_LOG_RECORD_SIZE, AuditLog_writeDone) == SUCCESS)
+		{
+			g_writing = True;
+			g_written = g_pending;
+			g_pending = 0;
+		}
+	}
+
+	SREG = sreg;
+}
+
+/*
+ * Description :
+ * TWI callback of a page write, the records added meanwhile are queued in one write.
+ * The records of a failed write are written again with them, they are still in the RAM
+ * page, up to AUDIT_LOG_WRITE_RETRIES times. Then they are lost and the next ones are
+ * still written.
+ */
+static void AuditLog_writeDone(uint8 status)
+{
+	g_writing = False;
+
+	if(status == TWI_TRANSACTION_OK)
+	{
+		g_retries = 0;
+	}
+	else if(g_retries < AUDIT_LOG_WRITE_RETRIES)
+	{
+		/* They are just before the pending ones, the write starts from them again */
+		g_retries++;
+		g_pending += g_written;
+	}
+	else
+	{
+		g_retries = 0;
+	}
+
+	AuditLog_flush();
+}
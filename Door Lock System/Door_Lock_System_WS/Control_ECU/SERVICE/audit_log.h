@@ -0,0 +1,119 @@
+ /******************************************************************************
+ *
+ * Module: Audit Log
+ *
+ * File Name: audit_log.h
+ *
+ * Description: Header file for the append only access audit log kept in a
+ *              circular region of the external EEPROM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef AUDIT_LOG_H_
+#define AUDIT_LOG_H_
+
+#include "../LIB/std_types.h"
+#include "../HAL/external_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Circular region of fixed size records, between the log store and the user table.
+ * Records are collected in a RAM copy of the current page and written in the
+ * background, records added while a write is running go out with the next one.
+ */
+#define AUDIT_LOG_ADDRESS 0x300
+#define AUDIT_LOG_SIZE 0x300
+#define AUDIT_LOG_RECORD_SIZE 8
+#define AUDIT_LOG_RECORDS (AUDIT_LOG_SIZE / AUDIT_LOG_RECORD_SIZE)
+#define AUDIT_LOG_RECORDS_PER_PAGE (EEPROM_PAGE_SIZE / AUDIT_LOG_RECORD_SIZE)
+
+/*
+ * Records are numbered modulo AUDIT_LOG_SEQUENCE_MASK + 1, so an erased sequence (0xFFFF)
+ * is never a valid one. Consecutive slots hold consecutive numbers, which lets the
+ * boot find the newest record from the number in slot 0.
+ */
+#define AUDIT_LOG_SEQUENCE_MASK 0x7FFF
+#define AUDIT_LOG_ERASED_SEQUENCE 0xFFFF
+
+/* Times the records of a failed page write are written again before they are dropped */
+#define AUDIT_LOG_WRITE_RETRIES 2
+
+#if ((AUDIT_LOG_ADDRESS % EEPROM_PAGE_SIZE) != 0) || ((AUDIT_LOG_SIZE % EEPROM_PAGE_SIZE) != 0)
+#error "The audit log region should be made of whole pages"
+#endif
+
+#if (AUDIT_LOG_RECORDS > AUDIT_LOG_SEQUENCE_MASK)
+#error "The audit log should have less records than sequence numbers"
+#endif
+
+#if ((EEPROM_PAGE_SIZE % AUDIT_LOG_RECORD_SIZE) != 0)
+#error "The audit log records should not cross a page boundary"
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	AUDIT_EVENT_UNLOCK,
+	AUDIT_EVENT_WRONG_PASSWORD,
+	AUDIT_EVENT_LOCKOUT,
+	AUDIT_EVENT_PASSWORD_CHANGED,
+	AUDIT_EVENT_DOOR_FAULT, /* A door move ended without reaching its end, attempts holds the door state */
+	AUDIT_EVENT_DOOR_STALL /* The motor current stopped a door move, attempts holds the door state */
+}AuditLog_EventType;
+
+/* Image of one record in the EEPROM */
+typedef struct{
+	uint16 sequence;
+	uint8 event; /* AuditLog_EventType */
+	uint8 attempts; /* Wrong passwords entered in a row before the event */
+	uint32 timestamp; /* Value of the time source when the event was added */
+}AuditLog_RecordType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Find the newest record by reading the sequence number of every slot, a record lost by a
+ * failed write does not hide the ones after it. TWI should be initialized before.
+ * Returns SUCCESS, or the EEPROM error if a record could not be read.
+ */
+uint8 AuditLog_init(void);
+
+/*
+ * Description :
+ * Set the function that gives the timestamp of the new records. Without it the
+ * timestamp is 0.
+ */
+void AuditLog_setTimeSource(uint32 (*a_ptr)(void));
+
+/*
+ * Description :
+ * Add a record and return without waiting for the EEPROM, the page write is queued on
+ * the TWI engine. Waits only if the RAM page is needed again before the last write ended.
+ */
+void AuditLog_append(AuditLog_EventType event, uint8 attempts);
+
+/*
+ * Description :
+ * Returns the number of records kept, at most AUDIT_LOG_RECORDS.
+ */
+uint16 AuditLog_getCount(void);
+
+/*
+ * Description :
+ * Read the record number index, 0 being the oldest one kept. The records still in RAM
+ * are written first. Returns ERROR if there is no such record, otherwise SUCCESS or the
+ * EEPROM error.
+ */
+uint8 AuditLog_read(uint16 index, AuditLog_RecordType *record);
+
+#endif /* AUDIT_LOG_H_ */
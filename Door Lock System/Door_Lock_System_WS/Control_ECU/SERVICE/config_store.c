@@ -0,0 +1,191 @@
+ /******************************************************************************
+ *
+ * Module: Config Store
+ *
+ * File Name: config_store.c
+ *
+ * Description: Source file for the RAM shadow cache of the persistent lock
+ *              configuration (password and password set flag) kept in the
+ *              external EEPROM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "config_store.h"
+#include "log_store.h"
+#include "../MCAL/internal_eeprom.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Data of one log store record, the log store adds the sequence number and the CRC */
+typedef struct{
+	uint8 password_set;
+	uint8 password[PASSWORD_SIZE];
+}ConfigStore_RecordType;
+
+/* Image of the hot copy in the internal EEPROM */
+typedef struct{
+	uint8 magic;
+	uint8 password_set;
+	uint16 version;
+}ConfigStore_HotType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static ConfigStore_RecordType g_cache;
+static boolean g_loaded = False; /* The cache holds what is in the EEPROM */
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 ConfigStore_migrate(void);
+static void ConfigStore_saveHot(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 ConfigStore_init(void)
+{
+	uint8 status;
+
+	status = LogStore_init();
+	if(status == SUCCESS)
+	{
+		if(LogStore_isEmpty())
+		{
+			/* Nothing saved yet, take the old layout or start without a password */
+			status = ConfigStore_migrate();
+		}
+		else
+		{
+			status = LogStore_read((uint8 *)&g_cache, sizeof(g_cache));
+		}
+	}
+	if(status != SUCCESS)
+	{
+		g_loaded = False;
+		return status;
+	}
+
+	g_loaded = True;
+	ConfigStore_saveHot();
+	return SUCCESS;
+}
+
+boolean ConfigStore_isPasswordSet(void)
+{
+	ConfigStore_HotType hot;
+
+	if(!g_loaded && (ConfigStore_init() != SUCCESS))
+	{
+		/* The internal EEPROM can not be disturbed from the bus, fail closed without it */
+		IEEPROM_readBlock(CONFIG_STORE_HOT_ADDRESS, (uint8 *)&hot, sizeof(hot));
+		return (hot.magic == CONFIG_STORE_HOT_MAGIC) ? hot.password_set : True;
+	}
+
+	return g_cache.password_set;
+}
+
+boolean ConfigStore_checkPassword(const uint8 *password)
+{
+	uint8 i;
+
+	if(!g_loaded || !g_cache.password_set)
+	{
+		return False;
+	}
+
+	for(i = 0; i < PASSWORD_SIZE; i++)
+	{
+		if(password[i] != g_cache.password[i])
+		{
+			return False;
+		}
+	}
+
+	return True;
+}
+
+uint8 ConfigStore_setPassword(const uint8 *password)
+{
+	ConfigStore_RecordType record;
+	uint8 status;
+	uint8 i;
+
+	record.password_set = 1;
+	for(i = 0; i < PASSWORD_SIZE; i++)
+	{
+		record.password[i] = password[i];
+	}
+
+	/* Write through, the record goes to the next slot and the old one stays as it is */
+	status = LogStore_append((const uint8 *)&record, sizeof(record));
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+
+	g_cache = record;
+	g_loaded = True;
+	ConfigStore_saveHot();
+	return SUCCESS;
+}
+
+/*
+ * Description :
+ * Fill the cache from the flag and password locations used before the record existed.
+ * If a password was set there, it is saved again as a record and the old flag is cleared,
+ * so a log store found empty later does not bring the old password back.
+ */
+static uint8 ConfigStore_migrate(void)
+{
+	uint8 flag;
+	uint8 status;
+
+	status = EEPROM_readByte(CONFIG_STORE_LEGACY_FLAG_ADDRESS, &flag);
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+
+	if(flag == 1)
+	{
+		status = EEPROM_readBlock(CONFIG_STORE_LEGACY_PASSWORD_ADDRESS, g_cache.password, PASSWORD_SIZE);
+		if(status != SUCCESS)
+		{
+			return status;
+		}
+		status = ConfigStore_setPassword(g_cache.password);
+		if(status != SUCCESS)
+		{
+			return status;
+		}
+		/* Only after the record is saved, a reset in between migrates again */
+		return EEPROM_writeByte(CONFIG_STORE_LEGACY_FLAG_ADDRESS, 0);
+	}
+
+	g_cache.password_set = 0;
+	return SUCCESS;
+}
+
+/*
+ * Description :
+ * Queue the cached flag and the record version to the internal EEPROM, the driver
+ * only writes the bytes that changed.
+ */
+static void ConfigStore_saveHot(void)
+{
+	ConfigStore_HotType hot;
+
+	hot.magic = CONFIG_STORE_HOT_MAGIC;
+	hot.password_set = g_cache.password_set;
+	hot.version = LogStore_getSequence();
+	IEEPROM_writeBlock(CONFIG_STORE_HOT_ADDRESS, (const uint8 *)&hot, sizeof(hot));
+}
@@ -0,0 +1,74 @@
+ /******************************************************************************
+ *
+ * Module: Config Store
+ *
+ * File Name: config_store.h
+ *
+ * Description: Header file for the RAM shadow cache of the persistent lock
+ *              configuration (password and password set flag) kept in the
+ *              external EEPROM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+#include "../LIB/std_types.h"
+#include "../HAL/external_eeprom.h" /* SUCCESS and the EEPROM error codes */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define PASSWORD_SIZE 5
+
+/*
+ * Hot copy of the password set flag in the internal EEPROM:
+ * | MAGIC | PASSWORD SET | VERSION (2 bytes) |
+ * The version is the log store sequence of the record it was taken from. The flag is
+ * answered from it when the external EEPROM could not be read.
+ */
+#define CONFIG_STORE_HOT_ADDRESS 0x00
+#define CONFIG_STORE_HOT_MAGIC 0xC5
+
+/* Locations used before the record existed, read once to migrate old devices */
+#define CONFIG_STORE_LEGACY_PASSWORD_ADDRESS 0x00
+#define CONFIG_STORE_LEGACY_FLAG_ADDRESS 0xDD
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Find the newest valid configuration record in the log store and cache it. Without a
+ * valid record the defaults are used (no password set). The hot copy in the internal
+ * EEPROM is updated if it differs. TWI and IEEPROM should be initialized before.
+ * Returns SUCCESS, or the EEPROM error if the record could not be read.
+ */
+uint8 ConfigStore_init(void);
+
+/*
+ * Description :
+ * Check if a password is saved, from the cache. If the record could not be read at
+ * boot it is read again, and while the external EEPROM fails the hot copy is used, or
+ * the password is reported as set so a new password can not be forced by disturbing the bus.
+ */
+boolean ConfigStore_isPasswordSet(void);
+
+/*
+ * Description :
+ * Compare the password with the cached one. Returns False if no password is cached.
+ */
+boolean ConfigStore_checkPassword(const uint8 *password);
+
+/*
+ * Description :
+ * Save a new password as a new log store record, the EEPROM is written first and the
+ * cache is updated only if the write succeeded. Returns SUCCESS or the EEPROM error.
+ */
+uint8 ConfigStore_setPassword(const uint8 *password);
+
+#endif /* CONFIG_STORE_H_ */
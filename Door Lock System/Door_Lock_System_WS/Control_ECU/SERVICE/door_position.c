@@ -0,0 +1,166 @@
+ /******************************************************************************
+ *
+ * Module: Door Position
+ *
+ * File Name: door_position.c
+ *
+ * Description: Source file for the end stops and the encoder of the door
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "door_position.h"
+#include "motion_profile.h"
+#include "../MCAL/gpio.h"
+#include "../MCAL/timer1.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#if (DOOR_POSITION_SLOWDOWN_PULSES >= DOOR_POSITION_TRAVEL_PULSES)
+#error "The deceleration should start after the first pulse of the travel"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Changed by the ISR callbacks and by DoorPosition_track with the interrupts disabled */
+static volatile DoorPosition_TargetType g_target = DOOR_POSITION_NONE;
+static volatile uint16 g_pulses = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void DoorPosition_arrive(void);
+static void DoorPosition_openStop(void);
+static void DoorPosition_closedStop(void);
+#if DOOR_POSITION_ENCODER
+static void DoorPosition_pulse(void);
+#endif
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void DoorPosition_init(void)
+{
+	/* The edge is the switch closing, the bounces after it find no tracked move */
+	ExtInt_ConfigType open_stop = {DOOR_POSITION_OPEN_STOP, EXT_INT_FALLING_EDGE};
+	ExtInt_ConfigType closed_stop = {DOOR_POSITION_CLOSED_STOP, EXT_INT_FALLING_EDGE};
+
+	g_target = DOOR_POSITION_NONE;
+
+	ExtInt_setCallBack(DOOR_POSITION_OPEN_STOP, DoorPosition_openStop);
+	ExtInt_setCallBack(DOOR_POSITION_CLOSED_STOP, DoorPosition_closedStop);
+	ExtInt_init(&open_stop);
+	ExtInt_init(&closed_stop);
+	GPIO_WRITE_PIN(PORTD_ID, PIN2_ID, LOGIC_HIGH); /* Pull-ups */
+	GPIO_WRITE_PIN(PORTD_ID, PIN3_ID, LOGIC_HIGH);
+
+#if DOOR_POSITION_ENCODER
+	GPIO_SETUP_PIN_DIRECTION(PORTD_ID, PIN6_ID, PIN_INPUT);
+	GPIO_WRITE_PIN(PORTD_ID, PIN6_ID, LOGIC_HIGH); /* Pull-up, a disconnected encoder does not count noise */
+	Timer1_setCaptureCallBack(DoorPosition_pulse);
+	Timer1_enableCapture(CAPTURE_RISING_EDGE);
+#endif
+}
+
+void DoorPosition_track(DoorPosition_TargetType target)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	g_pulses = 0;
+	g_target = target;
+	if((target != DOOR_POSITION_NONE) && DoorPosition_isAt(target))
+	{
+		DoorPosition_arrive();
+	}
+
+	SREG = sreg;
+}
+
+boolean DoorPosition_isTracking(void)
+{
+	return (g_target != DOOR_POSITION_NONE);
+}
+
+boolean DoorPosition_isAt(DoorPosition_TargetType target)
+{
+	switch(target)
+	{
+	case DOOR_POSITION_OPEN:
+		return (GPIO_READ_PIN(PORTD_ID, PIN2_ID) == LOGIC_LOW);
+	case DOOR_POSITION_CLOSED:
+		return (GPIO_READ_PIN(PORTD_ID, PIN3_ID) == LOGIC_LOW);
+	default:
+		return False;
+	}
+}
+
+uint16 DoorPosition_getPulses(void)
+{
+	uint16 pulses;
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+	pulses = g_pulses;
+	SREG = sreg;
+
+	return pulses;
+}
+
+/*
+ * Description :
+ * The target is reached, brake and stop tracking. Called with the interrupts disabled.
+ */
+static void DoorPosition_arrive(void)
+{
+	g_target = DOOR_POSITION_NONE;
+	Motion_brake();
+}
+
+static void DoorPosition_openStop(void)
+{
+	if(g_target == DOOR_POSITION_OPEN)
+	{
+		DoorPosition_arrive();
+	}
+}
+
+static void DoorPosition_closedStop(void)
+{
+	if(g_target == DOOR_POSITION_CLOSED)
+	{
+		DoorPosition_arrive();
+	}
+}
+
+#if DOOR_POSITION_ENCODER
+/*
+ * Description :
+ * Capture callback, one call per encoder pulse.
+ */
+static void DoorPosition_pulse(void)
+{
+	if(g_target == DOOR_POSITION_NONE)
+	{
+		return;
+	}
+
+	g_pulses++;
+	if(g_pulses == (DOOR_POSITION_TRAVEL_PULSES - DOOR_POSITION_SLOWDOWN_PULSES))
+	{
+		Motion_decelerate();
+	}
+	else if(g_pulses >= DOOR_POSITION_TRAVEL_PULSES)
+	{
+		DoorPosition_arrive();
+	}
+}
+#endif
@@ -0,0 +1,89 @@
+ /******************************************************************************
+ *
+ * Module: Door Position
+ *
+ * File Name: door_position.h
+ *
+ * Description: Header file for the end stops and the encoder of the door
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef DOOR_POSITION_H_
+#define DOOR_POSITION_H_
+
+#include "../LIB/std_types.h"
+#include "../MCAL/ext_interrupt.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * End stops, switches to ground closed when the door is at the end, with the internal pull-ups.
+ * INT2 is on PB2 which drives the motor, so only INT0 and INT1 are used.
+ */
+#define DOOR_POSITION_OPEN_STOP EXT_INT0 /* PD2 */
+#define DOOR_POSITION_CLOSED_STOP EXT_INT1 /* PD3 */
+
+/*
+ * 1 when an encoder on the motor shaft drives ICP1 (PD6), 0 to rely on the end stops only.
+ * The encoder output may be push-pull or open collector, PD6 gets the internal pull-up.
+ * Off by default, nothing is wired to PD6 on the current board.
+ */
+#define DOOR_POSITION_ENCODER 0
+
+/* Encoder pulses from one end to the other, and before the end where the deceleration starts */
+#define DOOR_POSITION_TRAVEL_PULSES 1200
+#define DOOR_POSITION_SLOWDOWN_PULSES 150
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	DOOR_POSITION_NONE, /* No move is tracked */
+	DOOR_POSITION_OPEN,
+	DOOR_POSITION_CLOSED
+}DoorPosition_TargetType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Enable the end stop interrupts and the encoder capture. Timer1 should be initialized.
+ */
+void DoorPosition_init(void);
+
+/*
+ * Description :
+ * Track the move started with Motion_start towards target, DOOR_POSITION_NONE stops tracking.
+ * The move decelerates near the end of the travel and brakes on the end stop or at the
+ * last pulse of the travel, whichever comes first. It brakes at once when the door is already
+ * at target, the profile duration is left as a ceiling when neither happens.
+ */
+void DoorPosition_track(DoorPosition_TargetType target);
+
+/*
+ * Description :
+ * Returns True while the tracked move has not reached its target. Still True once the
+ * move is over means it ran to the ceiling of its profile.
+ */
+boolean DoorPosition_isTracking(void);
+
+/*
+ * Description :
+ * Returns True when the end stop of target is closed.
+ */
+boolean DoorPosition_isAt(DoorPosition_TargetType target);
+
+/*
+ * Description :
+ * Returns the encoder pulses since the tracked move started.
+ */
+uint16 DoorPosition_getPulses(void);
+
+#endif /* DOOR_POSITION_H_ */
@@ -0,0 +1,195 @@
+ /******************************************************************************
+ *
+ * Module: Log Store
+ *
+ * File Name: log_store.c
+ *
+ * Description: Source file for the wear leveled log structured record store
+ *              on top of the external EEPROM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "log_store.h"
+#include "../LIB/crc16.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * Image of one slot in the EEPROM, the CRC covers the sequence and the data.
+ * The commit byte is derived from the sequence, so a commit byte left from an
+ * older record in the same slot never validates a new, partly written one.
+ * Bit 7 is kept clear so it can never read as LOG_STORE_UNCOMMITTED.
+ */
+typedef struct{
+	uint16 sequence;
+	uint8 data[LOG_STORE_DATA_SIZE];
+	uint16 crc;
+	uint8 commit;
+}LogStore_SlotType;
+
+#define LOG_STORE_COMMIT_VALUE(sequence) ((uint8)~(sequence) & 0x7F)
+#define LOG_STORE_UNCOMMITTED 0xFF
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static boolean g_empty = True;
+static uint8 g_newestSlot = LOG_STORE_SLOTS - 1; /* So the first record goes to slot 0 */
+static uint16 g_newestSequence = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint16 LogStore_slotCrc(const LogStore_SlotType *slot);
+static boolean LogStore_isSlotValid(const LogStore_SlotType *slot);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 LogStore_init(void)
+{
+	LogStore_SlotType slot;
+	uint8 status;
+	uint8 i;
+
+	g_empty = True;
+	g_newestSlot = LOG_STORE_SLOTS - 1;
+	g_newestSequence = 0;
+
+	for(i = 0; i < LOG_STORE_SLOTS; i++)
+	{
+		status = EEPROM_readBlock(LOG_STORE_ADDRESS + (uint32)i * LOG_STORE_SLOT_SIZE, (uint8 *)&slot, sizeof(slot));
+		if(status != SUCCESS)
+		{
+			return status;
+		}
+
+		if(!LogStore_isSlotValid(&slot))
+		{
+			continue; /* Blank slot, interrupted write or record never committed */
+		}
+
+		/* Sequence numbers wrap, a record is newer if it is ahead by less than half the range */
+		if(g_empty || ((sint16)(slot.sequence - g_newestSequence) > 0))
+		{
+			g_empty = False;
+			g_newestSlot = i;
+			g_newestSequence = slot.sequence;
+		}
+	}
+
+	return SUCCESS;
+}
+
+boolean LogStore_isEmpty(void)
+{
+	return g_empty;
+}
+
+uint16 LogStore_getSequence(void)
+{
+	return g_newestSequence;
+}
+
+uint8 LogStore_read(uint8 *data, uint8 size)
+{
+	if(g_empty)
+	{
+		return ERROR;
+	}
+
+	if(size > LOG_STORE_DATA_SIZE)
+	{
+		size = LOG_STORE_DATA_SIZE;
+	}
+
+	/* Data starts right after the sequence number */
+	return EEPROM_readBlock(LOG_STORE_ADDRESS + (uint32)g_newestSlot * LOG_STORE_SLOT_SIZE + sizeof(uint16), data, size);
+}
+
+uint8 LogStore_append(const uint8 *data, uint8 size)
+{
+	LogStore_SlotType slot;
+	LogStore_SlotType check;
+	uint32 address;
+	uint8 next;
+	uint8 status;
+	uint8 i;
+
+	next = (g_newestSlot + 1) % LOG_STORE_SLOTS;
+	address = LOG_STORE_ADDRESS + (uint32)next * LOG_STORE_SLOT_SIZE;
+
+	slot.sequence = g_newestSequence + 1;
+	for(i = 0; i < LOG_STORE_DATA_SIZE; i++)
+	{
+		slot.data[i] = (i < size) ? data[i] : 0xFF;
+	}
+	slot.crc = LogStore_slotCrc(&slot);
+	slot.commit = LOG_STORE_UNCOMMITTED;
+
+	/* First write cycle: a slot is exactly one page, the record is not valid yet */
+	status = EEPROM_writeBlock(address, (const uint8 *)&slot, sizeof(slot));
+	if(status == SUCCESS)
+	{
+		status = EEPROM_waitReady();
+	}
+	if(status == SUCCESS)
+	{
+		status = EEPROM_readBlock(address, (uint8 *)&check, sizeof(check));
+	}
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+
+	/* Commit only what really landed in the EEPROM */
+	for(i = 0; i < sizeof(slot); i++)
+	{
+		if(((const uint8 *)&slot)[i] != ((const uint8 *)&check)[i])
+		{
+			return ERROR;
+		}
+	}
+
+	/* Second write cycle: the single commit byte makes the new record the newest one */
+	slot.commit = LOG_STORE_COMMIT_VALUE(slot.sequence);
+	status = EEPROM_writeByte(address + (sizeof(slot) - sizeof(slot.commit)), slot.commit);
+	if(status == SUCCESS)
+	{
+		status = EEPROM_waitReady();
+	}
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+
+	g_empty = False;
+	g_newestSlot = next;
+	g_newestSequence = slot.sequence;
+	return SUCCESS;
+}
+
+/*
+ * Description :
+ * CRC of the slot fields that come before the CRC itself.
+ */
+static uint16 LogStore_slotCrc(const LogStore_SlotType *slot)
+{
+	return CRC16_update(CRC16_INITIAL_VALUE, (const uint8 *)slot, sizeof(slot->sequence) + sizeof(slot->data));
+}
+
+/*
+ * Description :
+ * A slot holds a record only if its CRC is right and it has been committed.
+ */
+static boolean LogStore_isSlotValid(const LogStore_SlotType *slot)
+{
+	return (slot->crc == LogStore_slotCrc(slot)) && (slot->commit == LOG_STORE_COMMIT_VALUE(slot->sequence));
+}
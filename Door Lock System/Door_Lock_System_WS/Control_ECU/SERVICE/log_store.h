@@ -0,0 +1,78 @@
+ /******************************************************************************
+ *
+ * Module: Log Store
+ *
+ * File Name: log_store.h
+ *
+ * Description: Header file for the wear leveled log structured record store
+ *              on top of the external EEPROM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef LOG_STORE_H_
+#define LOG_STORE_H_
+
+#include "../LIB/std_types.h"
+#include "../HAL/external_eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The reserved area is split in page sized slots, each holding one record:
+ * | SEQUENCE (2 bytes) | DATA (LOG_STORE_DATA_SIZE bytes) | CRC16 (2 bytes) | COMMIT (1 byte) |
+ * Records are appended round robin, so every slot is written once every
+ * LOG_STORE_SLOTS updates and the endurance grows with the area size.
+ *
+ * A record is written in two write cycles: the page with COMMIT left erased, then,
+ * once the page is read back correctly, the COMMIT byte alone. Only committed
+ * records are taken by the scan, so a power loss at any point leaves either the
+ * previous record or the new one as the newest valid record.
+ */
+#define LOG_STORE_ADDRESS 0x100
+#define LOG_STORE_SLOT_SIZE EEPROM_PAGE_SIZE
+#define LOG_STORE_SLOTS 32
+#define LOG_STORE_DATA_SIZE (LOG_STORE_SLOT_SIZE - 5)
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Scan all the slots once and remember the newest committed record with a valid CRC.
+ * Returns SUCCESS, or the EEPROM error if a slot could not be read.
+ */
+uint8 LogStore_init(void);
+
+/*
+ * Description :
+ * Returns True if the scan found no valid record.
+ */
+boolean LogStore_isEmpty(void);
+
+/*
+ * Description :
+ * Returns the sequence number of the newest record, it changes with every append.
+ */
+uint16 LogStore_getSequence(void);
+
+/*
+ * Description :
+ * Read size bytes (at most LOG_STORE_DATA_SIZE) of the newest record, one EEPROM read.
+ * Returns ERROR if the store is empty, otherwise SUCCESS or the EEPROM error.
+ */
+uint8 LogStore_read(uint8 *data, uint8 size);
+
+/*
+ * Description :
+ * Write size bytes (at most LOG_STORE_DATA_SIZE) as a new record in the slot after the
+ * newest one and commit it. The older records are left untouched.
+ * Returns SUCCESS, ERROR if the page did not read back as written, or the EEPROM error.
+ */
+uint8 LogStore_append(const uint8 *data, uint8 size);
+
+#endif /* LOG_STORE_H_ */
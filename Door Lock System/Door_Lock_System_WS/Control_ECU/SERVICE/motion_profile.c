@@ -0,0 +1,224 @@
+ /******************************************************************************
+ *
+ * Module: Motion Profile
+ *
+ * File Name: motion_profile.c
+ *
+ * Description: Source file for the trapezoidal speed profile of the door motor
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "motion_profile.h"
+#include "sw_timer.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*
+ * Share of the cruise speed at each step of a ramp, 255 being the cruise speed.
+ * Linear for a trapezoidal profile, another shape only needs another table.
+ */
+static const uint8 g_rampTable[MOTION_RAMP_STEPS] = {
+		16, 32, 48, 64, 80, 96, 112, 128, 143, 159, 175, 191, 207, 223, 239, 255
+};
+
+/* Changed by the tick callback and by the functions below with the interrupts disabled */
+static volatile Motion_PhaseType g_phase = MOTION_IDLE;
+static volatile uint16 g_elapsed = 0; /* Time spent in the current phase */
+static Motion_ProfileType g_profile;
+static DcMotor_State g_direction = STOP;
+static SwTimer_Type g_timer;
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Motion_tick(void);
+static void Motion_enterPhase(Motion_PhaseType phase);
+static uint16 Motion_phaseLength(Motion_PhaseType phase);
+static uint8 Motion_rampSpeed(uint16 time, uint16 length);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Motion_init(void)
+{
+	SwTimer_stop(&g_timer);
+	g_phase = MOTION_IDLE;
+	DcMotor_Rotate(STOP, ZERO_SPEED);
+}
+
+void Motion_setCallBack(void (*a_ptr)(void))
+{
+	g_callBackPtr = a_ptr;
+}
+
+void Motion_start(DcMotor_State direction, const Motion_ProfileType *profile)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	g_profile = *profile;
+	g_direction = direction;
+	Motion_enterPhase(MOTION_ACCELERATING);
+	if(g_phase != MOTION_IDLE)
+	{
+		SwTimer_start(&g_timer, MOTION_TICK_MS, MOTION_TICK_MS, Motion_tick);
+	}
+
+	SREG = sreg;
+}
+
+void Motion_decelerate(void)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if(g_phase == MOTION_ACCELERATING)
+	{
+		g_profile.cruise_ms = 0;
+	}
+	else if(g_phase == MOTION_CRUISING)
+	{
+		Motion_enterPhase(MOTION_DECELERATING);
+	}
+
+	SREG = sreg;
+}
+
+void Motion_brake(void)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if((g_phase != MOTION_IDLE) && (g_phase != MOTION_BRAKING))
+	{
+		Motion_enterPhase(MOTION_BRAKING);
+	}
+
+	SREG = sreg;
+}
+
+Motion_PhaseType Motion_getPhase(void)
+{
+	return g_phase;
+}
+
+uint32 Motion_getDuration(const Motion_ProfileType *profile)
+{
+	return (uint32)profile->accel_ms + profile->cruise_ms + profile->decel_ms + profile->brake_ms;
+}
+
+/*
+ * Description :
+ * Periodic callback of g_timer, moves the speed along the ramp and ends the phases.
+ * Along a ramp only the duty cycle changes, the direction pins and the PWM period are left alone.
+ */
+static void Motion_tick(void)
+{
+	g_elapsed += MOTION_TICK_MS;
+
+	if(g_elapsed >= Motion_phaseLength(g_phase))
+	{
+		Motion_enterPhase((Motion_PhaseType)(g_phase + 1));
+	}
+	else if(g_phase == MOTION_ACCELERATING)
+	{
+		DcMotor_setSpeed(Motion_rampSpeed(g_elapsed, g_profile.accel_ms));
+	}
+	else if(g_phase == MOTION_DECELERATING)
+	{
+		DcMotor_setSpeed(Motion_rampSpeed(g_profile.decel_ms - g_elapsed, g_profile.decel_ms));
+	}
+}
+
+/*
+ * Description :
+ * Set the output at the start of phase, skipping the phases of 0 ms.
+ * After the brake phase the motor is stopped and the callback is called.
+ * Called with the interrupts disabled.
+ */
+static void Motion_enterPhase(Motion_PhaseType phase)
+{
+	while((phase <= MOTION_BRAKING) && (Motion_phaseLength(phase) == 0))
+	{
+		phase++;
+	}
+
+	g_elapsed = 0;
+
+	switch(phase)
+	{
+	case MOTION_ACCELERATING:
+		DcMotor_Rotate(g_direction, Motion_rampSpeed(0, g_profile.accel_ms));
+		break;
+	case MOTION_CRUISING:
+	case MOTION_DECELERATING:
+		/* The deceleration starts from the cruise speed */
+		DcMotor_Rotate(g_direction, g_profile.cruise_speed);
+		break;
+	case MOTION_BRAKING:
+		DcMotor_Rotate(BRAKE, FULL_SPEED);
+		break;
+	default:
+		phase = MOTION_IDLE;
+		break;
+	}
+
+	g_phase = phase;
+
+	if(phase == MOTION_IDLE)
+	{
+		DcMotor_Rotate(STOP, ZERO_SPEED);
+		SwTimer_stop(&g_timer);
+		if(g_callBackPtr != NULL_PTR)
+		{
+			(*g_callBackPtr)();
+		}
+	}
+}
+
+/*
+ * Description :
+ * Returns the duration of phase in the current profile.
+ */
+static uint16 Motion_phaseLength(Motion_PhaseType phase)
+{
+	switch(phase)
+	{
+	case MOTION_ACCELERATING:
+		return g_profile.accel_ms;
+	case MOTION_CRUISING:
+		return g_profile.cruise_ms;
+	case MOTION_DECELERATING:
+		return g_profile.decel_ms;
+	case MOTION_BRAKING:
+		return g_profile.brake_ms;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Description :
+ * Returns the speed time ms after the start of a ramp of length ms, time < length.
+ */
+static uint8 Motion_rampSpeed(uint16 time, uint16 length)
+{
+	uint8 step = (uint8)(((uint32)time * MOTION_RAMP_STEPS) / length);
+
+	return (uint8)(((uint16)g_rampTable[step] * g_profile.cruise_speed) / 255);
+}
@@ -0,0 +1,102 @@
+ /******************************************************************************
+ *
+ * Module: Motion Profile
+ *
+ * File Name: motion_profile.h
+ *
+ * Description: Header file for the trapezoidal speed profile of the door motor
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef MOTION_PROFILE_H_
+#define MOTION_PROFILE_H_
+
+#include "../LIB/std_types.h"
+#include "../HAL/dc_motor.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Period of the speed updates, on the system tick */
+#define MOTION_TICK_MS 10
+
+/* Entries of the ramp table, the acceleration and the deceleration are split in as many steps */
+#define MOTION_RAMP_STEPS 16
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	MOTION_IDLE,
+	MOTION_ACCELERATING,
+	MOTION_CRUISING,
+	MOTION_DECELERATING,
+	MOTION_BRAKING
+}Motion_PhaseType;
+
+/*
+ * One move: ramp up to cruise_speed, keep it, ramp down to zero, then short the motor
+ * to stop it. A phase of 0 ms is skipped. The move lasts the sum of the four durations.
+ */
+typedef struct{
+	uint16 accel_ms;
+	uint16 cruise_ms;
+	uint16 decel_ms;
+	uint16 brake_ms;
+	uint8 cruise_speed; /* Percent, like DcMotor_Rotate */
+}Motion_ProfileType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Stop the motor. The system tick should be running.
+ */
+void Motion_init(void);
+
+/*
+ * Description :
+ * Set the function called when a move is over and the motor is stopped.
+ * It is called from the tick ISR.
+ */
+void Motion_setCallBack(void (*a_ptr)(void));
+
+/*
+ * Description :
+ * Start a move in direction (CW or A_CW), a running move is replaced.
+ * The profile is copied.
+ */
+void Motion_start(DcMotor_State direction, const Motion_ProfileType *profile);
+
+/*
+ * Description :
+ * Start the deceleration now, when the end of the travel is close.
+ * During the acceleration the cruise is skipped instead, the ramp down starts from the cruise speed.
+ */
+void Motion_decelerate(void);
+
+/*
+ * Description :
+ * End the move now with the brake phase of its profile, for an obstacle or an end stop.
+ */
+void Motion_brake(void);
+
+/*
+ * Description :
+ * Returns the phase of the current move, MOTION_IDLE when the motor is stopped.
+ */
+Motion_PhaseType Motion_getPhase(void);
+
+/*
+ * Description :
+ * Returns the time a move with profile lasts.
+ */
+uint32 Motion_getDuration(const Motion_ProfileType *profile);
+
+#endif /* MOTION_PROFILE_H_ */
@@ -0,0 +1,74 @@
+ /******************************************************************************
+ *
+ * Module: Power
+ *
+ * File Name: power.c
+ *
+ * Description: Source file for the sleep modes and their residency counters
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "power.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static Power_ResidencyType g_residency[POWER_MODES];
+static uint32 (*g_timeSource)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Power_init(void)
+{
+	uint8 mode;
+
+	for(mode = 0; mode < POWER_MODES; mode++)
+	{
+		g_residency[mode].sleeps = 0;
+		g_residency[mode].time_ms = 0;
+	}
+}
+
+void Power_setTimeSource(uint32 (*time_source)(void))
+{
+	g_timeSource = time_source;
+}
+
+void Power_sleep(Power_ModeType mode)
+{
+	uint32 start = 0;
+
+	if(g_timeSource != NULL_PTR)
+	{
+		start = (*g_timeSource)();
+	}
+
+	/* SM2:0 select the mode, the other bits of MCUCR hold the INT0/INT1 sense */
+	MCUCR = (MCUCR & 0x8F) | ((mode << 4) & 0x70);
+
+	/* The instruction after sei always runs before a pending ISR, so an interrupt
+	 * raised since the caller disabled them ends the sleep right away */
+	sleep_enable();
+	sei();
+	sleep_cpu();
+	sleep_disable();
+
+	g_residency[mode].sleeps++;
+	if(g_timeSource != NULL_PTR)
+	{
+		g_residency[mode].time_ms += (*g_timeSource)() - start;
+	}
+}
+
+void Power_getResidency(Power_ModeType mode, Power_ResidencyType *residency)
+{
+	*residency = g_residency[mode];
+}
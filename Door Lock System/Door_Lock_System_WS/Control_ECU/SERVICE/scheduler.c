@@ -0,0 +1,168 @@
+ /******************************************************************************
+ *
+ * Module: Scheduler
+ *
+ * File Name: scheduler.c
+ *
+ * Description: Source file for the cooperative run to completion scheduler
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "scheduler.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct{
+	void (*handler)(uint8 event);
+	uint8 queue[SCHEDULER_QUEUE_SIZE];
+	uint8 head; /* Moved by Scheduler_post, with the interrupts disabled */
+	uint8 tail; /* Moved by Scheduler_dispatch only */
+}Scheduler_TaskType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile Scheduler_TaskType g_tasks[SCHEDULER_MAX_TASKS];
+static uint8 g_taskCount = 0;
+static void (*g_idleHook)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static boolean Scheduler_isIdle(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Scheduler_init(void)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+	g_taskCount = 0;
+	g_idleHook = NULL_PTR;
+	SREG = sreg;
+}
+
+uint8 Scheduler_addTask(void (*handler)(uint8 event))
+{
+	uint8 sreg;
+	uint8 task;
+
+	if(g_taskCount == SCHEDULER_MAX_TASKS)
+	{
+		return SCHEDULER_INVALID_TASK;
+	}
+
+	task = g_taskCount;
+	g_tasks[task].handler = handler;
+	g_tasks[task].head = 0;
+	g_tasks[task].tail = 0;
+
+	/* The ISRs only post to the tasks counted here */
+	sreg = SREG;
+	cli();
+	g_taskCount++;
+	SREG = sreg;
+
+	return task;
+}
+
+boolean Scheduler_post(uint8 task, uint8 event)
+{
+	uint8 sreg;
+	boolean posted = False;
+
+	if(task >= g_taskCount)
+	{
+		return False;
+	}
+
+	/* Posted from the ISRs and from the handlers, the head is moved atomically */
+	sreg = SREG;
+	cli();
+	if((uint8)(g_tasks[task].head - g_tasks[task].tail) < SCHEDULER_QUEUE_SIZE)
+	{
+		g_tasks[task].queue[g_tasks[task].head & (SCHEDULER_QUEUE_SIZE - 1)] = event;
+		g_tasks[task].head++;
+		posted = True;
+	}
+	SREG = sreg;
+
+	return posted;
+}
+
+boolean Scheduler_dispatch(void)
+{
+	uint8 task;
+	uint8 event;
+
+	for(task = 0; task < g_taskCount; task++)
+	{
+		if(g_tasks[task].head != g_tasks[task].tail)
+		{
+			/* Only this function takes events, the slot can be read before freeing it */
+			event = g_tasks[task].queue[g_tasks[task].tail & (SCHEDULER_QUEUE_SIZE - 1)];
+			g_tasks[task].tail++;
+
+			(*g_tasks[task].handler)(event);
+			return True;
+		}
+	}
+
+	return False;
+}
+
+void Scheduler_setIdleHook(void (*hook)(void))
+{
+	g_idleHook = hook;
+}
+
+void Scheduler_run(void)
+{
+	while(1)
+	{
+		if(Scheduler_dispatch())
+		{
+			continue;
+		}
+
+		/* Checked again with the interrupts disabled, an event posted by an ISR
+		 * after this check wakes the hook sleep at once */
+		cli();
+		if(Scheduler_isIdle() && (g_idleHook != NULL_PTR))
+		{
+			(*g_idleHook)();
+		}
+		sei();
+	}
+}
+
+/*
+ * Description :
+ * Returns True if no task has a waiting event.
+ */
+static boolean Scheduler_isIdle(void)
+{
+	uint8 task;
+
+	for(task = 0; task < g_taskCount; task++)
+	{
+		if(g_tasks[task].head != g_tasks[task].tail)
+		{
+			return False;
+		}
+	}
+
+	return True;
+}
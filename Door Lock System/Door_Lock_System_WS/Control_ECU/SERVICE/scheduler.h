@@ -0,0 +1,81 @@
+ /******************************************************************************
+ *
+ * Module: Scheduler
+ *
+ * File Name: scheduler.h
+ *
+ * Description: Header file for the cooperative run to completion scheduler
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define SCHEDULER_MAX_TASKS 4
+
+/* Events waiting for each task, a power of two up to 128 */
+#define SCHEDULER_QUEUE_SIZE 8
+
+/* Returned by Scheduler_addTask when the task table is full */
+#define SCHEDULER_INVALID_TASK 0xFF
+
+#if ((SCHEDULER_QUEUE_SIZE & (SCHEDULER_QUEUE_SIZE - 1)) != 0) || (SCHEDULER_QUEUE_SIZE > 128)
+#error "SCHEDULER_QUEUE_SIZE should be a power of two up to 128"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Remove every task and every waiting event.
+ */
+void Scheduler_init(void);
+
+/*
+ * Description :
+ * Add a task, its handler is called once for every event posted to it.
+ * The tasks added first have the higher priority.
+ * Returns the task id to post events to, or SCHEDULER_INVALID_TASK if the table is full.
+ */
+uint8 Scheduler_addTask(void (*handler)(uint8 event));
+
+/*
+ * Description :
+ * Queue an event for a task, from the application or from an ISR.
+ * Returns False if the event queue of the task is full, the event is lost then.
+ */
+boolean Scheduler_post(uint8 task, uint8 event);
+
+/*
+ * Description :
+ * Call the handler of the highest priority task with a waiting event, for one event.
+ * Returns False if no event was waiting.
+ */
+boolean Scheduler_dispatch(void);
+
+/*
+ * Description :
+ * Set the function called when no event is waiting, with the interrupts disabled.
+ * It may sleep until the next interrupt and should return with the interrupts enabled.
+ */
+void Scheduler_setIdleHook(void (*hook)(void));
+
+/*
+ * Description :
+ * Dispatch the events forever, calling the idle hook whenever none is waiting. Handlers run to completion, they should never wait
+ * for something that takes more than a few milliseconds; they post an event or start
+ * a software timer instead and return.
+ */
+void Scheduler_run(void);
+
+#endif /* SCHEDULER_H_ */
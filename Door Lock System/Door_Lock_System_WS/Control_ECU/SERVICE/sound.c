@@ -0,0 +1,140 @@
+ /******************************************************************************
+ *
+ * Module: Sound
+ *
+ * File Name: sound.c
+ *
+ * Description: Source file for the buzzer pattern sequencer
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "sound.h"
+#include "sw_timer.h"
+#include "../HAL/buzzer.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Steps of all the patterns, each one ends with a step of 0 ms */
+static const Sound_StepType g_steps[] PROGMEM = {
+		/* SOUND_CHIRP: one short high beep */
+		{150, 3}, {SOUND_END, 0},
+		/* SOUND_DOOR_CLOSING: a beep every half second while the door closes */
+		{125, 15}, {0, 35}, {SOUND_REPEAT, 0},
+		/* SOUND_ALARM: two tones siren */
+		{100, 25}, {75, 25}, {SOUND_REPEAT, 0}
+};
+
+/* First step of each pattern in g_steps */
+static const uint8 g_patternStart[SOUND_PATTERNS] PROGMEM = {0, 2, 5};
+
+/* Changed by the tick callback and by the functions below with the interrupts disabled */
+static volatile boolean g_playing = False;
+static volatile Sound_PatternType g_pattern;
+static volatile uint8 g_step; /* Index in g_steps of the step playing */
+static SwTimer_Type g_timer;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Sound_playStep(void);
+static void Sound_next(void);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Sound_init(void)
+{
+	SwTimer_stop(&g_timer);
+	g_playing = False;
+	Buzzer_off();
+}
+
+boolean Sound_play(Sound_PatternType pattern)
+{
+	boolean started = False;
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if(!g_playing || (pattern >= g_pattern))
+	{
+		g_pattern = pattern;
+		g_step = pgm_read_byte(&g_patternStart[pattern]);
+		g_playing = True;
+		Sound_playStep();
+		started = True;
+	}
+
+	SREG = sreg;
+
+	return started;
+}
+
+void Sound_stop(Sound_PatternType pattern)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if(g_playing && (g_pattern == pattern))
+	{
+		SwTimer_stop(&g_timer);
+		g_playing = False;
+		Buzzer_off();
+	}
+
+	SREG = sreg;
+}
+
+boolean Sound_isPlaying(Sound_PatternType pattern)
+{
+	return g_playing && (g_pattern == pattern);
+}
+
+/*
+ * Description :
+ * Play the step g_step, or restart or end the pattern at its last step.
+ * Called with the interrupts disabled.
+ */
+static void Sound_playStep(void)
+{
+	uint8 tone = pgm_read_byte(&g_steps[g_step].tone);
+	uint8 duration = pgm_read_byte(&g_steps[g_step].duration);
+
+	if(duration == 0)
+	{
+		if(tone != SOUND_REPEAT)
+		{
+			g_playing = False;
+			Buzzer_off();
+			return;
+		}
+		g_step = pgm_read_byte(&g_patternStart[g_pattern]);
+		tone = pgm_read_byte(&g_steps[g_step].tone);
+		duration = pgm_read_byte(&g_steps[g_step].duration);
+	}
+
+	Buzzer_tone((uint16)tone * SOUND_TONE_UNIT_HZ);
+	SwTimer_start(&g_timer, (uint16)duration * SOUND_TIME_UNIT_MS, 0, Sound_next);
+}
+
+/*
+ * Description :
+ * Callback of g_timer, the step is over.
+ */
+static void Sound_next(void)
+{
+	g_step++;
+	Sound_playStep();
+}
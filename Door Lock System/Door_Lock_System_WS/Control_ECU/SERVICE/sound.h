@@ -0,0 +1,77 @@
+ /******************************************************************************
+ *
+ * Module: Sound
+ *
+ * File Name: sound.h
+ *
+ * Description: Header file for the buzzer pattern sequencer
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef SOUND_H_
+#define SOUND_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Units of the pattern steps, a step fits in 2 bytes */
+#define SOUND_TONE_UNIT_HZ 20
+#define SOUND_TIME_UNIT_MS 10
+
+/* Tone of the last step of a pattern, which has a duration of 0 */
+#define SOUND_END 0 /* The pattern stops */
+#define SOUND_REPEAT 1 /* The pattern starts again */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* The patterns, a pattern does not replace one playing with a higher priority */
+typedef enum{
+	SOUND_CHIRP, /* A key was pressed, lowest priority */
+	SOUND_DOOR_CLOSING, /* Warning while the door closes */
+	SOUND_ALARM, /* Too many wrong passwords, highest priority */
+	SOUND_PATTERNS
+}Sound_PatternType;
+
+/* One step of a pattern in the flash table */
+typedef struct{
+	uint8 tone; /* SOUND_TONE_UNIT_HZ, 0 is silence */
+	uint8 duration; /* SOUND_TIME_UNIT_MS, 0 ends the pattern */
+}Sound_StepType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Silence the buzzer. The system tick should be running.
+ */
+void Sound_init(void);
+
+/*
+ * Description :
+ * Start pattern from its first step, the steps are advanced from the tick ISR.
+ * Returns False when a pattern with a higher priority is playing, it is not replaced.
+ */
+boolean Sound_play(Sound_PatternType pattern);
+
+/*
+ * Description :
+ * Stop pattern if it is the one playing, another pattern is left playing.
+ */
+void Sound_stop(Sound_PatternType pattern);
+
+/*
+ * Description :
+ * Returns True while pattern is playing.
+ */
+boolean Sound_isPlaying(Sound_PatternType pattern);
+
+#endif /* SOUND_H_ */
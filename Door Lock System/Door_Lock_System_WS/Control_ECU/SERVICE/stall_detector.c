@@ -0,0 +1,118 @@
+ /******************************************************************************
+ *
+ * Module: Stall Detector
+ *
+ * File Name: stall_detector.c
+ *
+ * Description: Source file for the door motor current monitoring
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "stall_detector.h"
+#include "sw_timer.h"
+#include "../MCAL/adc.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile uint16 g_threshold = STALL_DEFAULT_THRESHOLD;
+static volatile boolean g_armed = False;
+static volatile uint32 g_blankingEnd = 0; /* Timestamp from which the current is checked */
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Stall_sample(uint16 average);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Stall_init(void)
+{
+	ADC_ConfigType ADC_config = {
+			.ref_volt = ADC_AVCC,
+			.prescaler = ADC_PRESCALER_128 /* 62.5 kHz at 8 MHz */
+	};
+
+	g_armed = False;
+	g_threshold = STALL_DEFAULT_THRESHOLD;
+
+	ADC_init(&ADC_config);
+	ADC_setWindow(STALL_DEFAULT_WINDOW);
+	ADC_setCallBack(Stall_sample);
+}
+
+void Stall_setCallBack(void (*a_ptr)(void))
+{
+	g_callBackPtr = a_ptr;
+}
+
+boolean Stall_setThreshold(uint16 threshold)
+{
+	uint8 sreg;
+
+	if((threshold == 0) || (threshold > ADC_MAXIMUM_VALUE))
+	{
+		return False;
+	}
+
+	/* Two bytes read by the ADC ISR, write them together */
+	sreg = SREG;
+	cli();
+	g_threshold = threshold;
+	SREG = sreg;
+	return True;
+}
+
+boolean Stall_setWindow(uint8 window)
+{
+	return ADC_setWindow(window);
+}
+
+void Stall_arm(void)
+{
+	uint8 sreg;
+
+	/* The ADC ISR may still sample from the previous move */
+	sreg = SREG;
+	cli();
+	g_blankingEnd = SwTimer_getMs() + STALL_BLANKING_MS;
+	g_armed = True;
+	SREG = sreg;
+	ADC_startFreeRunning(STALL_ADC_CHANNEL);
+}
+
+void Stall_disarm(void)
+{
+	g_armed = False;
+	ADC_stop(); /* No wake up every sample while the motor is stopped */
+}
+
+/*
+ * Description :
+ * ADC callback, compares the average current with the threshold once the start is over.
+ */
+static void Stall_sample(uint16 average)
+{
+	if(!g_armed || !SwTimer_isReached(g_blankingEnd))
+	{
+		return;
+	}
+
+	if(average > g_threshold)
+	{
+		Stall_disarm();
+		if(g_callBackPtr != NULL_PTR)
+		{
+			(*g_callBackPtr)();
+		}
+	}
+}
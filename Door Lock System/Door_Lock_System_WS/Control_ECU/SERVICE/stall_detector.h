@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: Stall Detector
+ *
+ * File Name: stall_detector.h
+ *
+ * Description: Header file for the door motor current monitoring
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef STALL_DETECTOR_H_
+#define STALL_DETECTOR_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* ADC channel of the voltage across the shunt resistor of the H-bridge, PA0 */
+#define STALL_ADC_CHANNEL 0
+
+/*
+ * Defaults of the tunable settings. With the ADC clock at F_CPU/128 a sample is taken
+ * every 208 us, so 16 samples average the current over 3.3 ms.
+ */
+#define STALL_DEFAULT_THRESHOLD 600 /* ADC counts on AVCC */
+#define STALL_DEFAULT_WINDOW 16
+
+/* The start current of the motor is above the threshold, it is not checked at first */
+#define STALL_BLANKING_MS 150
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Set up the ADC and the default settings, nothing is monitored until Stall_arm.
+ * The system tick should be running.
+ */
+void Stall_init(void);
+
+/*
+ * Description :
+ * Set the function called from the ADC ISR when the average current passes the threshold.
+ * The monitoring is disarmed before it is called.
+ */
+void Stall_setCallBack(void (*a_ptr)(void));
+
+/*
+ * Description :
+ * Set the average current, in ADC counts, above which the motor is stalled.
+ * Returns False when it is 0 or out of the ADC range.
+ */
+boolean Stall_setThreshold(uint16 threshold);
+
+/*
+ * Description :
+ * Set the number of samples averaged, 1 to ADC_MAX_WINDOW. A larger window ignores
+ * shorter peaks but detects later. Returns False for a wrong window.
+ */
+boolean Stall_setWindow(uint8 window);
+
+/*
+ * Description :
+ * Start monitoring the current, at the start of a move.
+ */
+void Stall_arm(void);
+
+/*
+ * Description :
+ * Stop monitoring the current and the conversions.
+ */
+void Stall_disarm(void);
+
+#endif /* STALL_DETECTOR_H_ */
@@ -0,0 +1,300 @@
+ /******************************************************************************
+ *
+ * Module: User Table
+ *
+ * File Name: user_table.c
+ *
+ * Description: Source file for the table of user PINs kept in the external
+ *              EEPROM with a hashed index in RAM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "user_table.h"
+#include "../LIB/crc16.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Image of one record in the EEPROM */
+typedef struct{
+	uint8 state;
+	uint8 pin[PASSWORD_SIZE];
+	uint16 crc; /* Also the hash of the PIN in the index */
+}UserTable_RecordType;
+
+/* One index entry, the tag is the high byte of the PIN hash so most wrong entries are skipped without a read */
+typedef struct{
+	uint8 id;
+	uint8 tag;
+}UserTable_EntryType;
+
+#define USER_TABLE_NO_USER 0xFF
+#define USER_TABLE_HOME(hash) ((uint8)((hash) & (USER_TABLE_INDEX_SIZE - 1)))
+#define USER_TABLE_TAG(hash) ((uint8)((hash) >> 8))
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static UserTable_EntryType g_index[USER_TABLE_INDEX_SIZE];
+
+/* Home index entry of each user id, USER_TABLE_NO_USER for a free id */
+static uint8 g_home[USER_TABLE_USERS];
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint32 UserTable_address(uint8 id);
+static void UserTable_insert(uint8 id, uint16 hash);
+static uint8 UserTable_find(const uint8 *pin, uint16 hash, uint8 *id, UserTable_RecordType *record);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+uint8 UserTable_init(void)
+{
+	UserTable_RecordType record;
+	uint8 status;
+	uint8 i;
+
+	for(i = 0; i < USER_TABLE_INDEX_SIZE; i++)
+	{
+		g_index[i].id = USER_TABLE_NO_USER;
+	}
+	for(i = 0; i < USER_TABLE_USERS; i++)
+	{
+		g_home[i] = USER_TABLE_NO_USER;
+	}
+
+	for(i = 0; i < USER_TABLE_USERS; i++)
+	{
+		status = EEPROM_readBlock(UserTable_address(i), (uint8 *)&record, sizeof(record));
+		if(status != SUCCESS)
+		{
+			return status;
+		}
+
+		/* A torn write leaves a wrong CRC, the record is free then */
+		if(((record.state == USER_STATE_ENABLED) || (record.state == USER_STATE_DISABLED)) &&
+				(record.crc == CRC16_update(CRC16_INITIAL_VALUE, record.pin, PASSWORD_SIZE)))
+		{
+			UserTable_insert(i, record.crc);
+		}
+	}
+
+	return SUCCESS;
+}
+
+boolean UserTable_checkPin(const uint8 *pin, uint8 *id)
+{
+	UserTable_RecordType record;
+	uint8 user;
+
+	if(UserTable_find(pin, CRC16_update(CRC16_INITIAL_VALUE, pin, PASSWORD_SIZE), &user, &record) != SUCCESS)
+	{
+		return False;
+	}
+	if((user == USER_TABLE_NO_USER) || (record.state != USER_STATE_ENABLED))
+	{
+		return False;
+	}
+
+	if(id != NULL_PTR)
+	{
+		*id = user;
+	}
+	return True;
+}
+
+uint8 UserTable_add(uint8 id, const uint8 *pin)
+{
+	UserTable_RecordType record;
+	uint8 user;
+	uint8 status;
+	uint8 i;
+
+	if((id >= USER_TABLE_USERS) || (g_home[id] != USER_TABLE_NO_USER))
+	{
+		return ERROR;
+	}
+
+	/* Two users with the same PIN could not be told apart */
+	record.crc = CRC16_update(CRC16_INITIAL_VALUE, pin, PASSWORD_SIZE);
+	status = UserTable_find(pin, record.crc, &user, &record);
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+	if(user != USER_TABLE_NO_USER)
+	{
+		return ERROR;
+	}
+
+	record.state = USER_STATE_ENABLED;
+	for(i = 0; i < PASSWORD_SIZE; i++)
+	{
+		record.pin[i] = pin[i];
+	}
+	record.crc = CRC16_update(CRC16_INITIAL_VALUE, pin, PASSWORD_SIZE);
+
+	/* A record never crosses a page, so it costs one write cycle */
+	status = EEPROM_writeBlock(UserTable_address(id), (const uint8 *)&record, sizeof(record));
+	if(status == SUCCESS)
+	{
+		status = EEPROM_waitReady();
+	}
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+
+	UserTable_insert(id, record.crc);
+	return SUCCESS;
+}
+
+uint8 UserTable_remove(uint8 id)
+{
+	uint8 status;
+	uint8 hole;
+	uint8 next;
+	uint8 home;
+
+	if((id >= USER_TABLE_USERS) || (g_home[id] == USER_TABLE_NO_USER))
+	{
+		return ERROR;
+	}
+
+	status = EEPROM_writeByte(UserTable_address(id), USER_STATE_REMOVED);
+	if(status == SUCCESS)
+	{
+		status = EEPROM_waitReady();
+	}
+	if(status != SUCCESS)
+	{
+		return status;
+	}
+
+	/* The entry is in the probe sequence that starts at its home */
+	hole = g_home[id];
+	while(g_index[hole].id != id)
+	{
+		hole = (hole + 1) & (USER_TABLE_INDEX_SIZE - 1);
+	}
+	g_home[id] = USER_TABLE_NO_USER;
+
+	/* Move back the entries after the hole that could not be found any more across it */
+	next = hole;
+	while(1)
+	{
+		next = (next + 1) & (USER_TABLE_INDEX_SIZE - 1);
+		if(g_index[next].id == USER_TABLE_NO_USER)
+		{
+			break;
+		}
+
+		home = g_home[g_index[next].id];
+		if((hole <= next) ? ((hole < home) && (home <= next)) : ((hole < home) || (home <= next)))
+		{
+			continue; /* Its home is after the hole, it stays reachable */
+		}
+
+		g_index[hole] = g_index[next];
+		hole = next;
+	}
+	g_index[hole].id = USER_TABLE_NO_USER;
+
+	return SUCCESS;
+}
+
+uint8 UserTable_setEnabled(uint8 id, boolean enabled)
+{
+	uint8 status;
+
+	if((id >= USER_TABLE_USERS) || (g_home[id] == USER_TABLE_NO_USER))
+	{
+		return ERROR;
+	}
+
+	status = EEPROM_writeByte(UserTable_address(id), enabled ? USER_STATE_ENABLED : USER_STATE_DISABLED);
+	if(status == SUCCESS)
+	{
+		status = EEPROM_waitReady();
+	}
+	return status;
+}
+
+/*
+ * Description :
+ * EEPROM address of the record of a user id.
+ */
+static uint32 UserTable_address(uint8 id)
+{
+	return USER_TABLE_ADDRESS + (uint32)id * USER_TABLE_RECORD_SIZE;
+}
+
+/*
+ * Description :
+ * Put the user id in the first free entry from the home of its hash.
+ */
+static void UserTable_insert(uint8 id, uint16 hash)
+{
+	uint8 entry = USER_TABLE_HOME(hash);
+
+	while(g_index[entry].id != USER_TABLE_NO_USER)
+	{
+		entry = (entry + 1) & (USER_TABLE_INDEX_SIZE - 1);
+	}
+
+	g_index[entry].id = id;
+	g_index[entry].tag = USER_TABLE_TAG(hash);
+	g_home[id] = USER_TABLE_HOME(hash);
+}
+
+/*
+ * Description :
+ * Look for the user with this PIN from the home of its hash, only the entries with the same
+ * tag are read from the EEPROM. id is USER_TABLE_NO_USER if no user has it, otherwise record
+ * holds its record. Returns SUCCESS or the EEPROM error.
+ */
+static uint8 UserTable_find(const uint8 *pin, uint16 hash, uint8 *id, UserTable_RecordType *record)
+{
+	uint8 entry = USER_TABLE_HOME(hash);
+	uint8 status;
+	uint8 i;
+
+	*id = USER_TABLE_NO_USER;
+
+	/* The index is never full, so a free entry ends the probe sequence */
+	while(g_index[entry].id != USER_TABLE_NO_USER)
+	{
+		if(g_index[entry].tag == USER_TABLE_TAG(hash))
+		{
+			status = EEPROM_readBlock(UserTable_address(g_index[entry].id), (uint8 *)record, sizeof(*record));
+			if(status != SUCCESS)
+			{
+				return status;
+			}
+
+			for(i = 0; i < PASSWORD_SIZE; i++)
+			{
+				if(record->pin[i] != pin[i])
+				{
+					break;
+				}
+			}
+			if(i == PASSWORD_SIZE)
+			{
+				*id = g_index[entry].id;
+				return SUCCESS;
+			}
+		}
+		entry = (entry + 1) & (USER_TABLE_INDEX_SIZE - 1);
+	}
+
+	return SUCCESS;
+}
@@ -0,0 +1,93 @@
+ /******************************************************************************
+ *
+ * Module: User Table
+ *
+ * File Name: user_table.h
+ *
+ * Description: Header file for the table of user PINs kept in the external
+ *              EEPROM with a hashed index in RAM
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef USER_TABLE_H_
+#define USER_TABLE_H_
+
+#include "../LIB/std_types.h"
+#include "../HAL/external_eeprom.h"
+#include "config_store.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * One record per user id, at USER_TABLE_ADDRESS + id * USER_TABLE_RECORD_SIZE:
+ * | STATE (1 byte) | PIN (PASSWORD_SIZE bytes) | CRC16 of the PIN (2 bytes) |
+ * A record is added with one page write, enabling, disabling and removing a user
+ * only write the state byte.
+ */
+#define USER_TABLE_ADDRESS 0x600
+#define USER_TABLE_USERS 64
+#define USER_TABLE_RECORD_SIZE 8
+
+/* Record states, any other value (an erased byte too) is a free record */
+#define USER_STATE_ENABLED 0xA5
+#define USER_STATE_DISABLED 0x5A
+#define USER_STATE_REMOVED 0x00
+
+/*
+ * Open addressing index from the PIN hash to the user id, kept at most half full so a
+ * PIN is found with one probe in the usual case. Should be a power of two.
+ */
+#define USER_TABLE_INDEX_SIZE 128
+
+#if ((EEPROM_PAGE_SIZE % USER_TABLE_RECORD_SIZE) != 0) || ((USER_TABLE_ADDRESS % USER_TABLE_RECORD_SIZE) != 0)
+#error "The user records should not cross a page boundary"
+#endif
+
+#if ((USER_TABLE_INDEX_SIZE & (USER_TABLE_INDEX_SIZE - 1)) != 0) || (USER_TABLE_INDEX_SIZE < (2 * USER_TABLE_USERS))
+#error "The user index size should be a power of two and at least twice the number of users"
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Read all the records once and build the index of the users in use.
+ * Returns SUCCESS, or the EEPROM error if a record could not be read.
+ */
+uint8 UserTable_init(void);
+
+/*
+ * Description :
+ * Check if pin belongs to an enabled user, with one index probe and one record read.
+ * The user id is returned in id (if not NULL_PTR).
+ */
+boolean UserTable_checkPin(const uint8 *pin, uint8 *id);
+
+/*
+ * Description :
+ * Save pin for the free user id, the user starts enabled.
+ * Returns ERROR if the id is not valid or in use or the PIN is already used,
+ * otherwise SUCCESS or the EEPROM error.
+ */
+uint8 UserTable_add(uint8 id, const uint8 *pin);
+
+/*
+ * Description :
+ * Free the user id. Returns ERROR if it is not in use, otherwise SUCCESS or the EEPROM error.
+ */
+uint8 UserTable_remove(uint8 id);
+
+/*
+ * Description :
+ * Enable or disable the user id, a disabled user keeps its PIN but can not open the door.
+ * Returns ERROR if it is not in use, otherwise SUCCESS or the EEPROM error.
+ */
+uint8 UserTable_setEnabled(uint8 id, boolean enabled);
+
+#endif /* USER_TABLE_H_ */
@@ -4,17 +4,23 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../MCAL/ext_interrupt.c \
 ../MCAL/gpio.c \
+../MCAL/internal_eeprom.c \
 ../MCAL/timer1.c \
 ../MCAL/uart.c 
 
 OBJS += \
+./MCAL/ext_interrupt.o \
 ./MCAL/gpio.o \
+./MCAL/internal_eeprom.o \
 ./MCAL/timer1.o \
 ./MCAL/uart.o 
 
 C_DEPS += \
+./MCAL/ext_interrupt.d \
 ./MCAL/gpio.d \
+./MCAL/internal_eeprom.d \
 ./MCAL/timer1.d \
 ./MCAL/uart.d 
 
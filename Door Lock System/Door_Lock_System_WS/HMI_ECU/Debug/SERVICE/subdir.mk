@@ -0,0 +1,30 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../SERVICE/power.c \
+../SERVICE/protocol.c \
+../SERVICE/sw_timer.c 
+
+OBJS += \
+./SERVICE/power.o \
+./SERVICE/protocol.o \
+./SERVICE/sw_timer.o 
+
+C_DEPS += \
+./SERVICE/power.d \
+./SERVICE/protocol.d \
+./SERVICE/sw_timer.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+SERVICE/%.o: ../SERVICE/%.c SERVICE/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -40,56 +40,90 @@ static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
  *******************************************************************************/
 
 uint8 KEYPAD_getPressedKey(void)
+{
+	uint8 key;
+
+	while((key = KEYPAD_scanKey()) == KEYPAD_NO_KEY)
+	{
+		_delay_ms(5); /* Add small delay to fix CPU load issue in proteus */
+	}
+
+	return key;
+}
+
+uint8 KEYPAD_scanKey(void)
 {
 	uint8 col,row;
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
+	uint8 key = KEYPAD_NO_KEY;
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
+
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
 #if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
+	GPIO_SETUP_PIN_DIRECTION(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
 #endif
-	while(1)
+	for(row=0 ; (row<KEYPAD_NUM_ROWS) && (key == KEYPAD_NO_KEY) ; row++) /* loop for rows */
 	{
-		for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
-		{
-			/* 
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this row will be output pin
-			 */
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
+		/* 
+		 * Each time setup the direction for all keypad port as input pins,
+		 * except this row will be output pin
+		 */
+		GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
 
-			/* Set/Clear the row output pin */
-			GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
+		/* Set/Clear the row output pin */
+		GPIO_WRITE_PIN(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
 
-			for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
+		for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
+		{
+			/* Check if the switch is pressed in this column */
+			if(GPIO_READ_PIN(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
 			{
-				/* Check if the switch is pressed in this column */
-				if(GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col) == KEYPAD_BUTTON_PRESSED)
-				{
-					#if (KEYPAD_NUM_COLS == 3)
-						#ifdef STANDARD_KEYPAD
-							return ((row*KEYPAD_NUM_COLS)+col+1);
-						#else
-							return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-						#endif
-					#elif (KEYPAD_NUM_COLS == 4)
-						#ifdef STANDARD_KEYPAD
-							return ((row*KEYPAD_NUM_COLS)+col+1);
-						#else
-							return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-						#endif
+				#if (KEYPAD_NUM_COLS == 3)
+					#ifdef STANDARD_KEYPAD
+						key = ((row*KEYPAD_NUM_COLS)+col+1);
+					#else
+						key = KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
 					#endif
-				}
+				#elif (KEYPAD_NUM_COLS == 4)
+					#ifdef STANDARD_KEYPAD
+						key = ((row*KEYPAD_NUM_COLS)+col+1);
+					#else
+						key = KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
+					#endif
+				#endif
+				break;
 			}
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(5); /* Add small delay to fix CPU load issue in proteus */
 		}
-	}	
+		/* Release the row, the pins are left as inputs for the next scan */
+		GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
+	}
+
+	return key;
+}
+
+boolean KEYPAD_enableWakeUp(void)
+{
+	uint8 pin;
+
+	for(pin=0 ; pin<KEYPAD_NUM_ROWS ; pin++)
+	{
+		GPIO_SETUP_PIN_DIRECTION(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+pin,PIN_OUTPUT);
+		GPIO_WRITE_PIN(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+pin, KEYPAD_BUTTON_PRESSED);
+	}
+
+	for(pin=0 ; pin<KEYPAD_NUM_COLS ; pin++)
+	{
+		if(GPIO_READ_PIN(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+pin) == KEYPAD_BUTTON_PRESSED)
+		{
+			return False;
+		}
+	}
+
+	return True;
 }
 
 #ifndef STANDARD_KEYPAD
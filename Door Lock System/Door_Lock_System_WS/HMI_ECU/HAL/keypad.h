@@ -15,6 +15,7 @@
 #define KEYPAD_H_
 
 #include "../LIB/std_types.h"
+#include "../MCAL/ext_interrupt.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -35,6 +36,15 @@
 #define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
 #define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
 
+/*
+ * The columns are also wired through an AND gate to INT2 (PB2). With every row driven low,
+ * a press gives a falling edge on INT2, which can wake the MCU from the power down mode.
+ */
+#define KEYPAD_WAKE_UP_INTERRUPT          EXT_INT2
+
+/* Returned by KEYPAD_scanKey when no button is pressed */
+#define KEYPAD_NO_KEY                     0xFF
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -45,4 +55,18 @@
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Description :
+ * Scan the Keypad once without waiting, returns KEYPAD_NO_KEY if no button is pressed
+ */
+uint8 KEYPAD_scanKey(void);
+
+/*
+ * Description :
+ * Drive every row low so that any pressed button pulls its column low, for the wake up line
+ * made of the columns (see KEYPAD_WAKE_UP_INTERRUPT). The next scan sets the rows back.
+ * Returns False if a button is already pressed, no edge would come to wake the MCU then.
+ */
+boolean KEYPAD_enableWakeUp(void);
+
 #endif /* KEYPAD_H_ */
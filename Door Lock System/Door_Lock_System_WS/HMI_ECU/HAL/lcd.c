@@ -28,17 +28,17 @@
 void LCD_init(void)
 {
 	/* Configure the direction for RS and E pins as output pins */
-	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
 
 	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
 
 #if(LCD_DATA_BITS_MODE == 4)
 	/* Configure 4 pins in the data port as output pins */
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_OUTPUT);
+	GPIO_SETUP_PIN_DIRECTION(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
 
 	/* Send for 4 bit initialization of LCD  */
 	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
@@ -66,36 +66,36 @@ void LCD_init(void)
  */
 void LCD_sendCommand(uint8 command)
 {
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
+	GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
 	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
 	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
 
 #if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,7));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,4));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,5));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,6));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,7));
 
 	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
 	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
 	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
 
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,3));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,0));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,1));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,2));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,3));
 
 	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
 	_delay_ms(1); /* delay for processing Th = 13ns */
 
 #elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
+	GPIO_WRITE_PORT(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
 	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
 	_delay_ms(1); /* delay for processing Th = 13ns */
 #endif
 }
@@ -106,36 +106,36 @@ void LCD_sendCommand(uint8 command)
  */
 void LCD_displayCharacter(uint8 data)
 {
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
+	GPIO_WRITE_PIN(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
 	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
 	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
 
 #if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,5));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
 
 	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
 	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
 	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
 
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
+	GPIO_WRITE_PIN(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
 
 	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
 	_delay_ms(1); /* delay for processing Th = 13ns */
 
 #elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
+	GPIO_WRITE_PORT(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
 	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	GPIO_WRITE_PIN(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
 	_delay_ms(1); /* delay for processing Th = 13ns */
 #endif
 }
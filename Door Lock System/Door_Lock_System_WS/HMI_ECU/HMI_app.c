@@ -13,274 +13,465 @@
 
 
 #include <avr/io.h> // Standard AVR I/O Definitions
+#include <avr/interrupt.h> // To disable the interrupts before sleeping
 #include "HAL/lcd.h" // LCD Header File
 #include "HAL/keypad.h" // Keypad Header File
 #include "MCAL/uart.h" // UART Header File
-#include "MCAL/timer1.h" // Timer1 Header File
-#include <util/delay.h> // Utility functions for delays
-
-// Define constants for communication protocol
-#define IS_PASSWORD_SETTED 'Q'              // Indicates if password is already set
-#define SETTED 'W'                          // Indicates password is already set in EEPROM
-#define NOT_SETTED 'E'                      // Indicates password is not set in EEPROM yet
-#define GET_READY_FOR_PASSWORD 'R'          // Request for entering a password
-#define CORRECT_PASSWORD 'T'                // Indicates correct password
-#define NOT_CORRECT_PASSWORD 'Y'            // Indicates incorrect password
-#define OPEN_DOOR 'U'                       // Command to open the door
-#define ERROR_ACTION 'I'                    // Action taken when an error occurs
-#define GET_READY_FOR_PASSWORD_ONE 'O'      // Request for entering the first password for setup
-#define GET_READY_FOR_PASSWORD_TWO 'P'      // Request for entering the second password for setup
-#define IS_MATCHED 'A'                     // Indicates that two entered passwords matched
-#define MATCHED 'S'                        // Indicates that two entered passwords matched
-#define NOT_MATCHED 'D'                    // Indicates that two entered passwords did not match
+#include "MCAL/internal_eeprom.h" // Internal EEPROM Header File
+#include "MCAL/ext_interrupt.h" // External Interrupts Header File
+#include "SERVICE/protocol.h" // Inter-ECU Protocol Header File
+#include "SERVICE/sw_timer.h" // System Tick and Software Timers Header File
+#include "SERVICE/power.h" // Sleep Modes Header File
+#include "LIB/coroutine.h" // Stackless Coroutines Header File
 
 #define PASSWORD_SIZE 5 // Define password size
+#define PASSWORD_TRIES 3 // Wrong passwords in a row before the lockout
+
+#define HOT_STATE_MAGIC_ADDRESS 0x00 // Internal EEPROM, holds HOT_STATE_MAGIC once the flag below is valid
+#define HOT_STATE_PASSWORD_SET_ADDRESS 0x01 // Internal EEPROM, copy of the password set flag of the Control_ECU
+#define HOT_STATE_MAGIC 0xC5
+
+#define DOOR_STATUS_POLL_MS 250 // The door cycle is timed by the Control_ECU, its progress is read with GET_STATUS
+#define DOOR_START_POLLS 4 // GET_STATUS replies telling the door is closed before giving up on the cycle
+#define LOCKOUT_TIME_MS 60000
+#define LOCKOUT_BLINK_MS 500
+#define SPLASH_TIME_MS 2000
+#define MESSAGE_TIME_MS 1000 // Short messages like UNMATCHED
+#define KEYPAD_SCAN_MS 20 // A key is taken once two scans in a row read it
+
+// Send a request to the Control_ECU from coroutine co and wait for the reply opcode in reply,
+// FRAME_NACK if all the tries failed. The other coroutines run meanwhile. Keep it on one line.
+#define REQUEST(co, opcode, payload, length) \
+	do { \
+		request_opcode = (opcode); \
+		request_payload = (payload); \
+		request_length = (length); \
+		COROUTINE_SPAWN(co, &request_co, requestThread(&request_co)); \
+	} while (0)
+
+// One step of the door cycle as shown on the LCD
+typedef struct {
+	const char *text;
+	uint8 column;
+} DoorStepType;
+
+// Indexed by Protocol_DoorStateType
+const DoorStepType door_steps[] = {
+	{ "IS CLOSED", 3 },
+	{ "IS UNLOCKING", 2 },
+	{ "IS HOLDING", 3 },
+	{ "IS LOCKING", 3 }
+};
 
 uint8 i_counter; // Variable for loop iterations
 uint8 password_buffer[PASSWORD_SIZE]; // Array to store password
-volatile uint8 timer1_ticks = 0; // Volatile variable for Timer1 ticks
 
-// Configuration for Timer1
-Timer1_ConfigType Timer1_config = { .initial_value = 0, .compare_value = 31250,
-		.mode = COMPARE, // Compare mode
-		.prescaler = PRESCALER_256 // Prescaler value
-};
+// The coroutines lose their local variables at every wait, their state is kept here
+Coroutine_Type keypad_co; // Keypad scanning, always running
+Coroutine_Type menu_co; // Main menu, password setup and password checks
+Coroutine_Type pin_co; // Password entry, spawned by the menu
+Coroutine_Type door_co; // Door progress, spawned by the menu
+Coroutine_Type lockout_co; // Lockout display, spawned by the menu
+Coroutine_Type flag_co; // Password set flag query, spawned by the menu
+Coroutine_Type request_co; // Request to the Control_ECU, spawned through REQUEST
+
+uint8 key_pressed = KEYPAD_NO_KEY; // Last new key press, taken by readKey()
+uint8 key_candidate = KEYPAD_NO_KEY; // Key read by the previous scan
+uint8 key_state = KEYPAD_NO_KEY; // Debounced key, KEYPAD_NO_KEY once released
+uint8 key_wait_f = 0; // A flow waits for a key and nothing else, the MCU can power down
+uint8 menu_key; // '+' to open the door or '-' to change the password
+uint8 tries = 0; // Number of password entry attempts
+uint8 reply = 0; // Reply received from the Control_ECU
+uint8 request_opcode; // Request being sent by requestThread
+const uint8 *request_payload;
+uint8 request_length;
+uint8 request_sequence;
+uint8 request_tries;
+uint8 is_password_set_f = 0; // Flag to indicate if password is already set
+uint8 is_password_correct_f = 0; // Flag to indicate if entered password is correct
+uint8 door_step; // Step of the door cycle being shown
+uint8 door_polls; // GET_STATUS replies telling the door is still closed
+uint8 seconds_shown; // Countdown value on the LCD, written again only when it changes
+Protocol_FrameType reply_frame; // Last frame received from the Control_ECU
+uint32 keypad_deadline; // Timestamps on the system tick at which the waits end
+uint32 menu_deadline;
+uint32 door_deadline;
+uint32 lockout_deadline;
+uint32 blink_deadline;
+uint32 request_deadline;
 
 /*
  * Description:
- * This function is responsible for getting the password from the user through the keypad.
- * It uses the KEYPAD_getPressedKey() function to get the pressed keys and displays asterisks (*)
- * to hide the entered characters.
- * It waits until the user presses the '=' key to finish entering the password.
+ * This coroutine scans the keypad every KEYPAD_SCAN_MS and keeps a new key press
+ * in key_pressed. It never ends, it runs beside the other flows.
  */
-void getPassword(void);
+uint8 keypadThread(Coroutine_Type *co);
 
 /*
  * Description:
- * This function is responsible for sending the password through UART.
- * It takes a pointer to the password array as an argument and sends each character
- * of the password using the UART_sendByte() function.
- * It also includes a delay of 15 milliseconds after sending each character.
+ * This coroutine is the main flow: boot messages, password setup, menu and the
+ * password checks. It spawns the password entry, the door progress and the lockout.
  */
-void sendPassword(uint8 *password);
+uint8 menuThread(Coroutine_Type *co);
 
 /*
  * Description:
- * This function is used as a callback for Timer1.
- * It is called whenever Timer1 overflows or a compare match occurs.
- * It increments the volatile variable timer1_ticks.
+ * This coroutine is responsible for getting the password from the user through the keypad.
+ * It displays asterisks (*) to hide the entered characters and ends when the user
+ * presses the '=' key to finish entering the password.
  */
-void timer1TickIncrement(void);
+uint8 pinThread(Coroutine_Type *co);
 
-int main(void) {
-	uint8 tries = 0; // Number of password entry attempts
-	uint8 is_matched_f = 1; // Flag to indicate if passwords match
-	uint8 is_password_set_f = 0; // Flag to indicate if password is already set
-	uint8 is_password_correct_f = 0; // Flag to indicate if entered password is correct
+/*
+ * Description:
+ * This coroutine shows each step of the door cycle with the seconds left, as read
+ * from the Control_ECU. It ends once the door is closed again.
+ */
+uint8 doorThread(Coroutine_Type *co);
+
+/*
+ * Description:
+ * This coroutine blinks the unauthorized access message until LOCKOUT_TIME_MS has passed.
+ * The lockout ends on time whatever the blinking, both are measured on the system tick.
+ */
+uint8 lockoutThread(Coroutine_Type *co);
+
+/*
+ * Description:
+ * This coroutine sends the request set by REQUEST and waits for its reply, sending it
+ * again when the reply is corrupted, is a FRAME_NACK or did not come within
+ * PROTOCOL_REPLY_TIMEOUT_MS. The reply opcode is left in reply and the frame in reply_frame.
+ */
+uint8 requestThread(Coroutine_Type *co);
+
+/*
+ * Description:
+ * This coroutine asks the Control_ECU if a password is set and keeps the answer in
+ * is_password_set_f and in the internal EEPROM. Without an answer the flag is kept.
+ */
+uint8 passwordSetThread(Coroutine_Type *co);
+
+/*
+ * Description:
+ * This function reads the frames received so far without waiting. It returns 1 once one
+ * ends the current try of the request: its reply, a FRAME_NACK or a corrupted frame.
+ * Late replies of older requests are skipped.
+ */
+uint8 takeReply(void);
+
+/*
+ * Description:
+ * This function returns the key pressed since the last call, or KEYPAD_NO_KEY.
+ */
+uint8 readKey(void);
 
+/*
+ * Description:
+ * This function sleeps until the next interrupt once the coroutines have run.
+ * It powers down while a flow only waits for a key, the keypad wakes the MCU then.
+ * Otherwise it stays in IDLE, the Timer1 tick ends it within one millisecond.
+ */
+void enterSleep(void);
+
+/*
+ * Description:
+ * This function keeps a copy of the password set flag in the internal EEPROM,
+ * so the next boot does not have to ask the Control_ECU for it.
+ */
+void savePasswordSetFlag(uint8 flag);
+
+int main(void) {
 	// UART Configuration
 	UART_ConfigType UART_config = { .bit_data = EIGHT_BITS, .parity = NO_PARITY,
 			.stop_bit = ONE_STOP_BIT, .baud_rate = 9600 };
 
 	SREG |= 1 << 7; // Enable global interrupts
 	UART_init(&UART_config); // Initialize UART communication
+	Protocol_init(); // Initialize the framed protocol on top of UART
 	LCD_init(); // Initialize LCD
-	Timer1_setCallBack(timer1TickIncrement); // Set Timer1 callback function for ticks
+	SwTimer_init(); // Start the 1 ms system tick on Timer1
+	IEEPROM_init(); // Load the hot state kept in the internal EEPROM
+	Power_init(); // Clear the sleep residency counters
+	Power_setTimeSource(SwTimer_getMs);
+
+	COROUTINE_INIT(&keypad_co);
+	COROUTINE_INIT(&menu_co);
+
+	// Each call runs a coroutine until its next wait, the flows interleave on the single core
+	while (1) {
+		keypadThread(&keypad_co);
+		menuThread(&menu_co);
+		enterSleep();
+	}
+	return 0;
+}
+
+uint8 keypadThread(Coroutine_Type *co) {
+	uint8 key;
+	uint8 chirp;
+
+	COROUTINE_BEGIN(co);
+	while (1) {
+		keypad_deadline = SwTimer_getMs() + KEYPAD_SCAN_MS;
+		COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(keypad_deadline));
+
+		key = KEYPAD_scanKey();
+		// A press counts once, when the same key is read twice in a row after a release
+		if (key == key_candidate && key != key_state) {
+			key_state = key;
+			if (key != KEYPAD_NO_KEY) {
+				key_pressed = key;
+				chirp = PLAY_SOUND_CHIRP;
+				Protocol_sendFrame(PLAY_SOUND, &chirp, 1); // The Control ECU beeps, no reply is awaited
+			}
+		}
+		key_candidate = key;
+	}
+	COROUTINE_END(co);
+}
+
+uint8 menuThread(Coroutine_Type *co) {
+	COROUTINE_BEGIN(co);
 
 	LCD_displayStringRowColumn(0,3,"Door  Lock");
 	LCD_displayStringRowColumn(1,5, "System");
-	_delay_ms(2000);
+	menu_deadline = SwTimer_getMs() + SPLASH_TIME_MS;
+	COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(menu_deadline));
 	LCD_clearScreen();
 	LCD_displayStringRowColumn(0,0,"By:");
 	LCD_displayStringRowColumn(1,1,"Diaa  Abossrie");
-	_delay_ms(2000);
-
-	UART_sendByte(IS_PASSWORD_SETTED); // Send request to check if password is already set
-
-	// Check the response received from the Control_ECU
-	if (UART_recieveByte() == SETTED) {
-		is_password_set_f = 1; // Set flag indicating password is already set
+	menu_deadline = SwTimer_getMs() + SPLASH_TIME_MS;
+	COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(menu_deadline));
+
+	if (IEEPROM_readByte(HOT_STATE_MAGIC_ADDRESS) == HOT_STATE_MAGIC
+			&& IEEPROM_readByte(HOT_STATE_PASSWORD_SET_ADDRESS) == 1) {
+		// Known from a previous run, a NOT_SETTED reply corrects it if it is out of date
+		is_password_set_f = 1;
+	} else {
+		// Not known or not set yet, the password may have been saved without this ECU knowing it
+		COROUTINE_SPAWN(co, &flag_co, passwordSetThread(&flag_co));
 	}
 
 	while (1) {
-		if (is_password_set_f) { // Check if password is already set
-			tries = 0; // Reset number of password entry attempts
-			LCD_clearScreen(); // Clear the LCD screen
-			LCD_displayStringRowColumn(0, 0, "+ : Open Door"); // Display option to open the door
-			LCD_displayStringRowColumn(1, 0, "- : Change Pass"); // Display option to change the password
-
-			uint8 key = KEYPAD_getPressedKey(); // Get the pressed key from the keypad
-			_delay_ms(100); // Delay for 100 milliseconds (debouncing)
-
-			switch (key) {
-			case '+':
-				_delay_ms(200); // Wait for 200 milliseconds (debouncing)
-				while (tries <= 2 && !is_password_correct_f) {
-					is_password_correct_f = 0; // Reset flag for correct password entry
-					LCD_clearScreen(); // Clear the LCD screen
-					LCD_displayStringRowColumn(0, 0, "plz enter pass: "); // Prompt for password entry
-					LCD_moveCursor(1, 0); // Move cursor to the next line
-					UART_sendByte(GET_READY_FOR_PASSWORD); // Send request for password entry
-					getPassword(); // Get password from user
-					sendPassword(password_buffer); // Send password through UART
-					_delay_ms(15); // Delay for 15 milliseconds after sending each character
-
-					if (UART_recieveByte() == CORRECT_PASSWORD) { // Check if received password is correct
-						is_password_correct_f = 1; // Set flag indicating correct password
-						UART_sendByte(OPEN_DOOR); // Send command to open the door
-						Timer1_init(&Timer1_config); // Initialize Timer1 for timing operations
-
-						// Display messages to indicate door unlocking process
-						LCD_clearScreen();
-						LCD_displayStringRowColumn(0, 6, "DOOR");
-						LCD_displayStringRowColumn(1, 2, "IS UNLOCKING");
-
-						// Wait for Timer1 ticks to reach 15 (15 seconds)
-						while (timer1_ticks != 15)
-							;
-						timer1_ticks = 0; // Reset Timer1 ticks
-						Timer1_deinit(); // Deinitialize Timer1
-
-						// Reinitialize Timer1 for holding duration
-						Timer1_init(&Timer1_config);
-						LCD_clearScreen();
-						LCD_displayStringRowColumn(0, 6, "DOOR");
-						LCD_displayStringRowColumn(1, 3, "IS HOLDING");
-
-						// Wait for Timer1 ticks to reach 3 (3 seconds)
-						while (timer1_ticks != 3)
-							;
-						timer1_ticks = 0; // Reset Timer1 ticks
-						Timer1_deinit(); // Deinitialize Timer1
-
-						// Reinitialize Timer1 for locking process
-						Timer1_init(&Timer1_config);
-						LCD_clearScreen();
-						LCD_displayStringRowColumn(0, 6, "DOOR");
-						LCD_displayStringRowColumn(1, 3, "IS LOCKING");
-
-						// Wait for Timer1 ticks to reach 15 (15 seconds)
-						while (timer1_ticks != 15)
-							;
-						timer1_ticks = 0; // Reset Timer1 ticks
-						Timer1_deinit(); // Deinitialize Timer1
-					} else {
-						tries++; // Increment the number of password entry attempts
-					}
-				}
-				if (is_password_correct_f == 0) { // Check if password was incorrect
-					UART_sendByte(ERROR_ACTION); // Send error action command
-					LCD_clearScreen(); // Clear the LCD screen
-					Timer1_init(&Timer1_config); // Initialize Timer1 for timing operations
-
-					// Display unauthorized access message for 60 seconds
-					while (timer1_ticks != 60) {
-						LCD_displayStringRowColumn(0, 2, "UNAUTHORIZED");
-						LCD_displayStringRowColumn(1, 5, "ACCESS");
-						_delay_ms(500);
-						LCD_clearScreen();
-						_delay_ms(500);
-					}
-
-					timer1_ticks = 0; // Reset Timer1 ticks
-					Timer1_deinit(); // Deinitialize Timer1
-				}
-
-				is_password_correct_f = 0; // Reset flag for correct password entry
-				break; // Exit the switch statement
-
-			case '-':
-				_delay_ms(200); // Wait for 200 milliseconds (debouncing)
-				while (tries <= 2 && !is_password_correct_f) {
-					is_password_correct_f = 0; // Reset flag for correct password entry
-					LCD_clearScreen(); // Clear the LCD screen
-					LCD_displayStringRowColumn(0, 0, "plz enter pass: "); // Prompt for password entry
-					LCD_moveCursor(1, 0); // Move cursor to the next line
-					UART_sendByte(GET_READY_FOR_PASSWORD); // Send request for password entry
-					getPassword(); // Get password from user
-					sendPassword(password_buffer); // Send password through UART
-					_delay_ms(15); // Delay for 15 milliseconds after sending each character
-
-					if (UART_recieveByte() == CORRECT_PASSWORD) { // Check if received password is correct
-						is_password_set_f = 0; // Reset flag for password set
-						is_password_correct_f = 1; // Set flag indicating correct password
-					} else {
-						tries++; // Increment the number of password entry attempts
-					}
-				}
-				if (is_password_correct_f == 0) { // Check if password was incorrect
-					UART_sendByte(ERROR_ACTION); // Send error action command
-					LCD_clearScreen(); // Clear the LCD screen
-					Timer1_init(&Timer1_config); // Initialize Timer1 for timing operations
-
-					// Display unauthorized access message for 60 seconds
-					while (timer1_ticks != 60) {
-						LCD_displayStringRowColumn(0, 2, "UNAUTHORIZED");
-						LCD_displayStringRowColumn(1, 5, "ACCESS");
-						_delay_ms(500);
-						LCD_clearScreen();
-						_delay_ms(500);
-					}
-
-					timer1_ticks = 0; // Reset Timer1 ticks
-					Timer1_deinit(); // Deinitialize Timer1
-				}
-
-				break; // Exit the switch statement
-			}
-		} else {
-			is_matched_f = 1; // Reset flag for password match
+		if (!is_password_set_f) {
 			LCD_clearScreen(); // Clear the LCD screen
 			LCD_displayString("plz enter pass: "); // Prompt for password entry
 			LCD_moveCursor(1, 0); // Move cursor to the next line
-			UART_sendByte(GET_READY_FOR_PASSWORD_ONE); // Send request for first password entry
-			getPassword(); // Get password from user
-			sendPassword(password_buffer); // Send password through UART
+			COROUTINE_SPAWN(co, &pin_co, pinThread(&pin_co)); // Get password from user
+			REQUEST(co, GET_READY_FOR_PASSWORD_ONE, password_buffer, PASSWORD_SIZE); // Send first password
 
 			LCD_clearScreen(); // Clear the LCD screen
 			LCD_displayString("plz re-enter the"); // Prompt for re-entering password
 			LCD_displayStringRowColumn(1, 0, "same pass: "); // Display message for re-entering password
 			LCD_moveCursor(1, 11); // Move cursor to the last character position
+			COROUTINE_SPAWN(co, &pin_co, pinThread(&pin_co)); // Get password from user
+			REQUEST(co, GET_READY_FOR_PASSWORD_TWO, password_buffer, PASSWORD_SIZE); // Send second password
 
-			UART_sendByte(GET_READY_FOR_PASSWORD_TWO); // Send request for second password entry
-			getPassword(); // Get password from user
-			sendPassword(password_buffer); // Send password through UART
-
-			_delay_ms(15); // Delay for 15 milliseconds after sending password
-
-			UART_sendByte(IS_MATCHED); // Send request to check if passwords match
-			is_matched_f = UART_recieveByte(); // Receive response for password match
-
-			if (is_matched_f == MATCHED) { // Check if passwords matched
+			REQUEST(co, IS_MATCHED, NULL_PTR, 0);
+			if (reply == MATCHED) { // Check if passwords matched
 				is_password_set_f = 1; // Set flag indicating password is set
-				is_matched_f = 0; // Reset flag for password match
+				savePasswordSetFlag(1);
 			} else {
 				LCD_clearScreen(); // Clear the LCD screen
 				LCD_displayStringRowColumn(0, 3, "UNMATCHED!"); // Display unmatched message
-				LCD_displayStringRowColumn(0, 3, "TRY  AGAIN"); // Display retry message
+				LCD_displayStringRowColumn(1, 3, "TRY  AGAIN"); // Display retry message
+				menu_deadline = SwTimer_getMs() + MESSAGE_TIME_MS;
+				COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(menu_deadline));
+				// The MATCHED reply may have been lost, ask again or the setup may never end
+				COROUTINE_SPAWN(co, &flag_co, passwordSetThread(&flag_co));
 			}
+			continue;
+		}
+
+		tries = 0; // Reset number of password entry attempts
+		is_password_correct_f = 0; // Reset flag for correct password entry
+		LCD_clearScreen(); // Clear the LCD screen
+		LCD_displayStringRowColumn(0, 0, "+ : Open Door"); // Display option to open the door
+		LCD_displayStringRowColumn(1, 0, "- : Change Pass"); // Display option to change the password
+
+		// The keys pressed during the door cycle or the lockout are dropped
+		readKey();
+		key_wait_f = 1;
+		COROUTINE_WAIT_UNTIL(co, (menu_key = readKey()) == '+' || menu_key == '-');
+		key_wait_f = 0;
+
+		while (tries < PASSWORD_TRIES && !is_password_correct_f) {
+			LCD_clearScreen(); // Clear the LCD screen
+			LCD_displayStringRowColumn(0, 0, "plz enter pass: "); // Prompt for password entry
+			LCD_moveCursor(1, 0); // Move cursor to the next line
+			COROUTINE_SPAWN(co, &pin_co, pinThread(&pin_co)); // Get password from user
+
+			// Only the master password allows changing it, the door also opens with a user PIN
+			REQUEST(co, (menu_key == '+') ? GET_READY_FOR_PASSWORD : GET_READY_FOR_MASTER_PASSWORD, password_buffer, PASSWORD_SIZE);
+			if (reply == NOT_SETTED) {
+				// The saved flag was out of date, go back to the password setup
+				is_password_set_f = 0;
+				savePasswordSetFlag(0);
+				break;
+			}
+			if (reply == CORRECT_PASSWORD) {
+				is_password_correct_f = 1; // Set flag indicating correct password
+			} else {
+				tries++; // Increment the number of password entry attempts
+			}
+		}
+
+		if (is_password_correct_f) {
+			if (menu_key == '+') {
+				REQUEST(co, OPEN_DOOR, NULL_PTR, 0); // Send command to open the door
+				COROUTINE_SPAWN(co, &door_co, doorThread(&door_co));
+			} else {
+				is_password_set_f = 0; // Go to the password setup
+			}
+		} else if (is_password_set_f) { // Check if password was incorrect
+			REQUEST(co, ERROR_ACTION, NULL_PTR, 0); // Send error action command
+			LCD_clearScreen(); // Clear the LCD screen
+			COROUTINE_SPAWN(co, &lockout_co, lockoutThread(&lockout_co)); // Display unauthorized access message for 60 seconds
 		}
 	}
-	return 0;
+	COROUTINE_END(co);
+}
+
+uint8 pinThread(Coroutine_Type *co) {
+	COROUTINE_BEGIN(co);
+	key_wait_f = 1;
+	for (i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++) {
+		// Store pressed keys in password_buffer array
+		COROUTINE_WAIT_UNTIL(co, (password_buffer[i_counter] = readKey()) != KEYPAD_NO_KEY);
+		LCD_displayCharacter('*'); // Display asterisk to hide entered characters
+	}
+	COROUTINE_WAIT_UNTIL(co, readKey() == '='); // Wait until user presses '=' key (finish entering password)
+	key_wait_f = 0;
+	COROUTINE_END(co);
 }
 
-void sendPassword(uint8 *password) {
-    for (i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++) {
-        UART_sendByte(*(password + i_counter)); // Send each character of the password through UART
-        _delay_ms(15); // Delay for 15 milliseconds after sending each character
+uint8 doorThread(Coroutine_Type *co) {
+	COROUTINE_BEGIN(co);
+	door_step = DOOR_CLOSED;
+	door_polls = 0;
+
+	// The door may still be closed at the first replies, the Control_ECU starts the cycle after its ACK
+	while (door_step != DOOR_CLOSED || door_polls < DOOR_START_POLLS) {
+		REQUEST(co, GET_STATUS, NULL_PTR, 0);
+		if (reply == STATUS && reply_frame.length == 3 && reply_frame.payload[0] <= DOOR_LOCKING) {
+			if (reply_frame.payload[0] != door_step || door_polls == 0) {
+				door_step = reply_frame.payload[0];
+				LCD_clearScreen();
+				LCD_displayStringRowColumn(0, 6, "DOOR");
+				LCD_displayStringRowColumn(1, door_steps[door_step].column, door_steps[door_step].text);
+				seconds_shown = 0xFF;
+			}
+			// Seconds left, rounded up, in the top right corner
+			if (door_step != DOOR_CLOSED && reply_frame.payload[2] != seconds_shown) {
+				seconds_shown = reply_frame.payload[2];
+				LCD_displayStringRowColumn(0, 14, (seconds_shown < 10) ? " " : "");
+				LCD_intgerToString(seconds_shown);
+			}
+			// Once the cycle is seen the next closed reply ends it
+			door_polls = (door_step == DOOR_CLOSED) ? door_polls + 1 : DOOR_START_POLLS;
+		} else {
+			door_polls++; // No answer, do not wait for ever
+		}
+
+		door_deadline = SwTimer_getMs() + DOOR_STATUS_POLL_MS;
+		COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(door_deadline));
+	}
+	COROUTINE_END(co);
+}
+
+uint8 lockoutThread(Coroutine_Type *co) {
+	COROUTINE_BEGIN(co);
+	lockout_deadline = SwTimer_getMs() + LOCKOUT_TIME_MS; // Timestamp at which the lockout ends
+
+	while (!SwTimer_isReached(lockout_deadline)) {
+		LCD_displayStringRowColumn(0, 2, "UNAUTHORIZED");
+		LCD_displayStringRowColumn(1, 5, "ACCESS");
+		blink_deadline = SwTimer_getMs() + LOCKOUT_BLINK_MS;
+		COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(blink_deadline));
+		LCD_clearScreen();
+		blink_deadline = SwTimer_getMs() + LOCKOUT_BLINK_MS;
+		COROUTINE_WAIT_UNTIL(co, SwTimer_isReached(blink_deadline));
+	}
+	COROUTINE_END(co);
+}
+
+uint8 requestThread(Coroutine_Type *co) {
+	COROUTINE_BEGIN(co);
+	// The first try gets a new sequence number, the retries reuse it
+	request_sequence = Protocol_sendFrame(request_opcode, request_payload, request_length);
+
+	for (request_tries = 0; request_tries <= PROTOCOL_MAX_RETRIES; request_tries++) {
+		if (request_tries != 0) {
+			Protocol_resendFrame(request_opcode, request_sequence, request_payload, request_length);
+		}
+
+		// No reply in time counts as a failed try, the request or its reply was lost
+		reply = FRAME_NACK;
+		request_deadline = SwTimer_getMs() + PROTOCOL_REPLY_TIMEOUT_MS;
+		COROUTINE_WAIT_UNTIL(co, takeReply() || SwTimer_isReached(request_deadline));
+		if (reply != FRAME_NACK) {
+			COROUTINE_EXIT(co);
+		}
+	}
+	COROUTINE_END(co);
+}
+
+uint8 passwordSetThread(Coroutine_Type *co) {
+	COROUTINE_BEGIN(co);
+	REQUEST(co, IS_PASSWORD_SETTED, NULL_PTR, 0);
+	if (reply == SETTED) {
+		is_password_set_f = 1; // Set flag indicating password is already set
+		savePasswordSetFlag(1);
+	} else if (reply == NOT_SETTED) {
+		is_password_set_f = 0;
+		savePasswordSetFlag(0);
+	}
+	COROUTINE_END(co);
+}
+
+uint8 takeReply(void) {
+    Protocol_StatusType status;
+
+    while ((status = Protocol_poll(&reply_frame)) != PROTOCOL_NO_FRAME) {
+        if (status == PROTOCOL_FRAME_ERROR) {
+            reply = FRAME_NACK; // Corrupted, send the request again
+            return 1;
+        }
+        // A FRAME_NACK is always taken, the sequence of a corrupted request may not have been read correctly
+        if (reply_frame.sequence == request_sequence || reply_frame.opcode == FRAME_NACK) {
+            reply = reply_frame.opcode;
+            return 1;
+        }
     }
+    return 0;
+}
+
+uint8 readKey(void) {
+    uint8 key = key_pressed;
+
+    key_pressed = KEYPAD_NO_KEY; // Each press is read once
+    return key;
 }
 
-void getPassword(void) {
-    for (i_counter = 0; i_counter < PASSWORD_SIZE; i_counter++) {
-        *(password_buffer + i_counter) = KEYPAD_getPressedKey(); // Store pressed keys in password_buffer array
-        LCD_displayCharacter('*'); // Display asterisk to hide entered characters
-        _delay_ms(500); // Delay for 500 milliseconds (debouncing)
+void enterSleep(void) {
+    ExtInt_ConfigType key_wake_config = { .id = KEYPAD_WAKE_UP_INTERRUPT, .sense = EXT_INT_FALLING_EDGE };
+
+    cli(); // An interrupt after the checks below still wakes the sleep at once
+    // Power down only when no key is being debounced and nothing needs the I/O clock:
+    // the last frame is sent and no internal EEPROM byte waits for its ready interrupt
+    if (key_wait_f && key_state == KEYPAD_NO_KEY && key_candidate == KEYPAD_NO_KEY
+            && key_pressed == KEYPAD_NO_KEY && UART_isTxComplete() && IEEPROM_isIdle()
+            && KEYPAD_enableWakeUp()) {
+        ExtInt_init(&key_wake_config);
+        Power_sleep(POWER_DOWN); // The tick stops, no deadline is waited for now
+        ExtInt_deinit(KEYPAD_WAKE_UP_INTERRUPT);
+    } else {
+        Power_sleep(POWER_IDLE);
     }
-    while (KEYPAD_getPressedKey() != '='); // Wait until user presses '=' key (finish entering password)
 }
 
-void timer1TickIncrement(void) {
-    timer1_ticks++; // Increment the volatile variable timer1_ticks
+void savePasswordSetFlag(uint8 flag) {
+    IEEPROM_writeByte(HOT_STATE_PASSWORD_SET_ADDRESS, flag); // Queued, written by the EEPROM ready interrupt
+    IEEPROM_writeByte(HOT_STATE_MAGIC_ADDRESS, HOT_STATE_MAGIC); // Queued after the flag, so the flag is valid once it is set
 }
 
@@ -0,0 +1,57 @@
+ /******************************************************************************
+ *
+ * Module: Common - Coroutine
+ *
+ * File Name: coroutine.h
+ *
+ * Description: Stackless coroutines (protothreads) written as plain C functions
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef COROUTINE_H_
+#define COROUTINE_H_
+
+#include "std_types.h"
+
+/*
+ * A coroutine is a function returning COROUTINE_WAITING or COROUTINE_ENDED, its body
+ * placed between COROUTINE_BEGIN and COROUTINE_END. It is called again and again by the
+ * main loop; every wait returns at once and the next call resumes after that wait.
+ *
+ * Only the resume point is kept, in a Coroutine_Type of 2 bytes. Local variables are lost
+ * at every wait, the values used across a wait should be static or global.
+ * A switch statement can not be used around a wait, the resume points are its cases,
+ * and a source line can hold only one wait since the line number names its resume point.
+ */
+typedef struct{
+	uint16 line; /* Source line to resume at, 0 to start from the beginning */
+}Coroutine_Type;
+
+#define COROUTINE_WAITING 0
+#define COROUTINE_ENDED   1
+
+/* Start the coroutine from its beginning at the next call */
+#define COROUTINE_INIT(co)       ((co)->line = 0)
+
+#define COROUTINE_BEGIN(co)      switch((co)->line) { case 0:
+
+#define COROUTINE_END(co)        } (co)->line = 0; return COROUTINE_ENDED
+
+/* Return and go on with the next statement at the next call */
+#define COROUTINE_YIELD(co) \
+	do { (co)->line = __LINE__; return COROUTINE_WAITING; case __LINE__:; } while(0)
+
+/* Return until condition is true, it is checked again at every call */
+#define COROUTINE_WAIT_UNTIL(co, condition) \
+	do { (co)->line = __LINE__; case __LINE__: if(!(condition)) return COROUTINE_WAITING; } while(0)
+
+/* Run the child coroutine call until it ends, the child context is started over first */
+#define COROUTINE_SPAWN(co, child, call) \
+	do { COROUTINE_INIT(child); COROUTINE_WAIT_UNTIL(co, (call) == COROUTINE_ENDED); } while(0)
+
+/* Leave the coroutine, it starts from its beginning at the next call */
+#define COROUTINE_EXIT(co)       do { (co)->line = 0; return COROUTINE_ENDED; } while(0)
+
+#endif /* COROUTINE_H_ */
@@ -0,0 +1,36 @@
+ /******************************************************************************
+ *
+ * Module: Common - CRC16
+ *
+ * File Name: crc16.h
+ *
+ * Description: CRC-16 (CCITT) helper used to protect frames and stored records
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include "std_types.h"
+#include <util/crc16.h> /* avr-libc optimized CRC update */
+
+/* Initial value of the CRC-16 register */
+#define CRC16_INITIAL_VALUE 0xFFFF
+
+/*
+ * Description :
+ * Continue the CRC calculation over size bytes of data starting from crc.
+ * Pass CRC16_INITIAL_VALUE as crc to start a new calculation.
+ */
+static inline uint16 CRC16_update(uint16 crc, const uint8 *data, uint8 size)
+{
+	while(size--)
+	{
+		crc = _crc_ccitt_update(crc, *data++);
+	}
+	return crc;
+}
+
+#endif /* CRC16_H_ */
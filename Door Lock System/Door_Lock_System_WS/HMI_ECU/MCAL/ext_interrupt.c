@@ -0,0 +1,112 @@
+ /******************************************************************************
+ *
+ * Module: External Interrupts
+ *
+ * File Name: ext_interrupt.c
+ *
+ * Description: Source file for the AVR INT0, INT1 and INT2 driver
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "ext_interrupt.h"
+#include "gpio.h"
+#include "avr/io.h" /* To use the External Interrupts Registers */
+#include "avr/interrupt.h" /* For External Interrupts ISR */
+#include "../LIB/common_macros.h" /* To use the macros like SET_BIT */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Callback of each line, in the order of ExtInt_IdType */
+static void (*volatile g_callBackPtr[3])(void) = {NULL_PTR, NULL_PTR, NULL_PTR};
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(INT0_vect)
+{
+	if(g_callBackPtr[EXT_INT0] != NULL_PTR)
+	{
+		(*g_callBackPtr[EXT_INT0])();
+	}
+}
+
+ISR(INT1_vect)
+{
+	if(g_callBackPtr[EXT_INT1] != NULL_PTR)
+	{
+		(*g_callBackPtr[EXT_INT1])();
+	}
+}
+
+ISR(INT2_vect)
+{
+	if(g_callBackPtr[EXT_INT2] != NULL_PTR)
+	{
+		(*g_callBackPtr[EXT_INT2])();
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void ExtInt_init(const ExtInt_ConfigType * Config_Ptr)
+{
+	switch(Config_Ptr->id)
+	{
+	case EXT_INT0:
+		GPIO_setupPinDirection(PORTD_ID, PIN2_ID, PIN_INPUT);
+		MCUCR = (MCUCR & 0xFC) | ((Config_Ptr->sense) & 0x03); /* ISC01 ISC00 */
+		GIFR = (1<<INTF0); /* Writing one clears the flag of an older event, a read-modify-write would clear the others too */
+		SET_BIT(GICR,INT0);
+		break;
+	case EXT_INT1:
+		GPIO_setupPinDirection(PORTD_ID, PIN3_ID, PIN_INPUT);
+		MCUCR = (MCUCR & 0xF3) | (((Config_Ptr->sense) & 0x03) << 2); /* ISC11 ISC10 */
+		GIFR = (1<<INTF1);
+		SET_BIT(GICR,INT1);
+		break;
+	case EXT_INT2:
+		GPIO_setupPinDirection(PORTB_ID, PIN2_ID, PIN_INPUT);
+
+		/* Changing ISC2 can raise INTF2, the line is disabled and the flag cleared after it */
+		CLEAR_BIT(GICR,INT2);
+		if(Config_Ptr->sense == EXT_INT_RISING_EDGE)
+		{
+			SET_BIT(MCUCSR,ISC2);
+		}
+		else
+		{
+			CLEAR_BIT(MCUCSR,ISC2);
+		}
+		GIFR = (1<<INTF2);
+		SET_BIT(GICR,INT2);
+		break;
+	}
+}
+
+void ExtInt_deinit(ExtInt_IdType id)
+{
+	switch(id)
+	{
+	case EXT_INT0:
+		CLEAR_BIT(GICR,INT0);
+		break;
+	case EXT_INT1:
+		CLEAR_BIT(GICR,INT1);
+		break;
+	case EXT_INT2:
+		CLEAR_BIT(GICR,INT2);
+		break;
+	}
+}
+
+void ExtInt_setCallBack(ExtInt_IdType id, void (*a_ptr)(void))
+{
+	g_callBackPtr[id] = a_ptr;
+}
@@ -14,6 +14,8 @@
 #define GPIO_H_
 
 #include "../LIB/std_types.h"
+#include "../LIB/common_macros.h"
+#include <avr/io.h>
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
@@ -34,6 +36,56 @@
 #define PIN6_ID                6
 #define PIN7_ID                7
 
+/*******************************************************************************
+ *                         Compile Time Pin Access                             *
+ *******************************************************************************/
+
+/*
+ * Same as the functions below for a port known at compile time: the port id has to be one
+ * of the PORTx_ID macros, or a macro defined as one, and selects the register by name.
+ * They save the function call, the range checks of the ids and the switch on the port, what
+ * remains is the bit operation on the register. The code the compiler makes of it depends on
+ * the pin, the value and the optimization level. The ids are not checked, the pin may be a variable.
+ * The functions stay for the ports chosen at run time.
+ */
+#define GPIO_SETUP_PIN_DIRECTION(port_id, pin_id, direction) \
+	do{ \
+		if((direction) == PIN_OUTPUT) SET_BIT(GPIO_DDR_REG(port_id), (pin_id)); \
+		else CLEAR_BIT(GPIO_DDR_REG(port_id), (pin_id)); \
+	}while(0)
+
+#define GPIO_WRITE_PIN(port_id, pin_id, value) \
+	do{ \
+		if((value) == LOGIC_HIGH) SET_BIT(GPIO_PORT_REG(port_id), (pin_id)); \
+		else CLEAR_BIT(GPIO_PORT_REG(port_id), (pin_id)); \
+	}while(0)
+
+#define GPIO_READ_PIN(port_id, pin_id) \
+	(BIT_IS_SET(GPIO_PIN_REG(port_id), (pin_id)) ? LOGIC_HIGH : LOGIC_LOW)
+
+#define GPIO_WRITE_PORT(port_id, value) (GPIO_PORT_REG(port_id) = (value))
+
+/* The id is expanded to its number first, then pasted to find the register */
+#define GPIO_DDR_REG(port_id) GPIO_DDR_REG_ID(port_id)
+#define GPIO_DDR_REG_ID(port_id) GPIO_DDR_##port_id
+#define GPIO_PORT_REG(port_id) GPIO_PORT_REG_ID(port_id)
+#define GPIO_PORT_REG_ID(port_id) GPIO_PORT_##port_id
+#define GPIO_PIN_REG(port_id) GPIO_PIN_REG_ID(port_id)
+#define GPIO_PIN_REG_ID(port_id) GPIO_PIN_##port_id
+
+#define GPIO_DDR_0 DDRA
+#define GPIO_DDR_1 DDRB
+#define GPIO_DDR_2 DDRC
+#define GPIO_DDR_3 DDRD
+#define GPIO_PORT_0 PORTA
+#define GPIO_PORT_1 PORTB
+#define GPIO_PORT_2 PORTC
+#define GPIO_PORT_3 PORTD
+#define GPIO_PIN_0 PINA
+#define GPIO_PIN_1 PINB
+#define GPIO_PIN_2 PINC
+#define GPIO_PIN_3 PIND
+
 /*******************************************************************************
  *                               Types Declaration                             *
  *******************************************************************************/
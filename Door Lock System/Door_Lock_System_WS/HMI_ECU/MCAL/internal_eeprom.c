@@ -0,0 +1,169 @@
+ /******************************************************************************
+ *
+ * Module: Internal EEPROM
+ *
+ * File Name: internal_eeprom.c
+ *
+ * Description: Source file for the AVR on-chip EEPROM driver
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "internal_eeprom.h"
+#include "avr/io.h" /* To use the EEPROM Registers */
+#include "avr/interrupt.h" /* For EEPROM ready ISR */
+#include "avr/eeprom.h" /* For the timed EEMWE/EEWE write sequence */
+#include "../LIB/common_macros.h" /* To use the macros like SET_BIT */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct{
+	uint16 address;
+	uint8 data;
+}IEEPROM_WriteType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* Copy of the first bytes, it already holds the queued values */
+static uint8 g_cache[IEEPROM_CACHE_SIZE];
+
+/* Writes waiting for the EEPROM, the head is moved by the application and the tail by the ISR */
+static volatile IEEPROM_WriteType g_queue[IEEPROM_QUEUE_SIZE];
+static volatile uint8 g_queueHead = 0;
+static volatile uint8 g_queueTail = 0;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/* Interrupt Service Routine for EEPROM Ready, the previous write cycle is over */
+ISR(EE_RDY_vect)
+{
+	if(g_queueHead != g_queueTail)
+	{
+		/* The library routine keeps EEWE within four cycles of EEMWE whatever the optimization */
+		eeprom_write_byte((uint8 *)g_queue[g_queueTail & (IEEPROM_QUEUE_SIZE - 1)].address,
+				g_queue[g_queueTail & (IEEPROM_QUEUE_SIZE - 1)].data);
+		g_queueTail++;
+	}
+	else
+	{
+		/* Nothing left to write, disable the interrupt until a new byte is queued */
+		CLEAR_BIT(EECR,EERIE);
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void IEEPROM_init(void)
+{
+	uint16 i;
+
+	g_queueHead = 0;
+	g_queueTail = 0;
+
+	for(i = 0; i < IEEPROM_CACHE_SIZE; i++)
+	{
+		g_cache[i] = eeprom_read_byte((const uint8 *)i);
+	}
+}
+
+uint8 IEEPROM_readByte(uint16 u16addr)
+{
+	uint8 data;
+	uint8 index;
+	uint8 sreg;
+
+	if(u16addr < IEEPROM_CACHE_SIZE)
+	{
+		return g_cache[u16addr];
+	}
+
+	sreg = SREG;
+	cli();
+
+	/* The newest queued value of the address is the one to return */
+	for(index = g_queueHead; index != g_queueTail; )
+	{
+		index--;
+		if(g_queue[index & (IEEPROM_QUEUE_SIZE - 1)].address == u16addr)
+		{
+			data = g_queue[index & (IEEPROM_QUEUE_SIZE - 1)].data;
+			SREG = sreg;
+			return data;
+		}
+	}
+
+	/* A read is ignored during a write cycle, wait for it with the interrupts enabled */
+	while(BIT_IS_SET(EECR,EEWE))
+	{
+		SREG = sreg;
+		cli();
+	}
+	data = eeprom_read_byte((const uint8 *)u16addr);
+
+	SREG = sreg;
+	return data;
+}
+
+void IEEPROM_readBlock(uint16 u16addr, uint8 *u8data, uint16 u16size)
+{
+	while(u16size--)
+	{
+		*u8data++ = IEEPROM_readByte(u16addr++);
+	}
+}
+
+boolean IEEPROM_writeByte(uint16 u16addr, uint8 u8data)
+{
+	return IEEPROM_writeBlock(u16addr, &u8data, 1);
+}
+
+boolean IEEPROM_writeBlock(uint16 u16addr, const uint8 *u8data, uint8 u8size)
+{
+	uint8 sreg;
+	uint8 i;
+
+	if((uint8)(IEEPROM_QUEUE_SIZE - (uint8)(g_queueHead - g_queueTail)) < u8size)
+	{
+		return False;
+	}
+
+	for(i = 0; i < u8size; i++, u16addr++)
+	{
+		/* Save the write cycle and the wear when the byte already holds the value */
+		if(IEEPROM_readByte(u16addr) == u8data[i])
+		{
+			continue;
+		}
+
+		if(u16addr < IEEPROM_CACHE_SIZE)
+		{
+			g_cache[u16addr] = u8data[i];
+		}
+
+		g_queue[g_queueHead & (IEEPROM_QUEUE_SIZE - 1)].address = u16addr;
+		g_queue[g_queueHead & (IEEPROM_QUEUE_SIZE - 1)].data = u8data[i];
+
+		/* The ISR also changes EECR, the interrupt fires as soon as no write cycle is running */
+		sreg = SREG;
+		cli();
+		g_queueHead++;
+		SET_BIT(EECR,EERIE);
+		SREG = sreg;
+	}
+
+	return True;
+}
+
+boolean IEEPROM_isIdle(void)
+{
+	return (g_queueHead == g_queueTail) && BIT_IS_CLEAR(EECR,EEWE);
+}
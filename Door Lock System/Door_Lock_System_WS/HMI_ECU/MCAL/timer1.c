@@ -31,7 +31,7 @@ void Timer1_init(const Timer1_ConfigType * Config_Ptr){
 
     /* Configure Timer1 mode (WGM10, WGM11 bits) */
     TCCR1A &= 0xFC;
-    TCCR1A |= (Config_Ptr -> mode) & 0x04;
+    TCCR1A |= (Config_Ptr -> mode) & 0x03;
 
     /* Configure Timer1 mode (WGM12, WGM13 bits) and Prescaler (CS10, CS11, CS12 bits) */
     TCCR1B &= 0xE7;
@@ -39,8 +39,13 @@ void Timer1_init(const Timer1_ConfigType * Config_Ptr){
     TCCR1B &= 0xF8;
     TCCR1B |= (Config_Ptr -> prescaler) & 0x07;
 
-    /* Enable the Timer1 compare interrupt and overflow interrupt */
-    TIMSK |= (1<<OCIE1A) | (1<<TOIE1);
+    /* Enable only the interrupt of the mode, in compare mode the counter never overflows
+     * and in normal mode OCR1A is not the period */
+    TIMSK &= ~((1<<OCIE1A) | (1<<TOIE1));
+    if((Config_Ptr -> mode) == COMPARE)
+        TIMSK |= (1<<OCIE1A);
+    else
+        TIMSK |= (1<<TOIE1);
 }
 
 /*
@@ -49,7 +54,7 @@ void Timer1_init(const Timer1_ConfigType * Config_Ptr){
  */
 void Timer1_deinit(void){
     TCCR1B = 0x00;
-    TIMSK &= 0xEB;
+    TIMSK &= ~((1<<OCIE1A) | (1<<TOIE1));
 }
 
 /*
@@ -62,10 +67,12 @@ void Timer1_setCallBack(void (*a_ptr)(void)){
 
 /* Interrupt Service Routine for Timer1 Compare Match A */
 ISR(TIMER1_COMPA_vect){
-    (*Timer1_CallBack_Ptr)();
+    if(Timer1_CallBack_Ptr != NULL_PTR)
+        (*Timer1_CallBack_Ptr)();
 }
 
 /* Interrupt Service Routine for Timer1 Overflow */
 ISR(TIMER1_OVF_vect){
-    (*Timer1_CallBack_Ptr)();
+    if(Timer1_CallBack_Ptr != NULL_PTR)
+        (*Timer1_CallBack_Ptr)();
 }
@@ -12,8 +12,71 @@
 
 #include "uart.h"
 #include "avr/io.h" /* To use the UART Registers */
+#include "avr/interrupt.h" /* For UART ISR */
 #include "../LIB/common_macros.h" /* To use the macros like SET_BIT */
 
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*
+ * Ring buffers shared between the UART ISRs and the application.
+ * The head index is only moved by the producer and the tail index only by the consumer,
+ * both are free running and masked on access, so no locking is needed on single byte indices.
+ */
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead = 0;
+static volatile uint8 g_rxTail = 0;
+
+static volatile uint8 g_txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 g_txHead = 0;
+static volatile uint8 g_txTail = 0;
+
+/* Set once the first byte is loaded in UDR, before that the TXC flag has no meaning */
+static volatile boolean g_txStarted = False;
+
+/* Called by the RX ISR after a byte is stored, to wake up whoever reads the buffer */
+static void (*volatile g_rxCallBackPtr)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+/* Interrupt Service Routine for UART Receive Complete */
+ISR(USART_RXC_vect)
+{
+	uint8 data = UDR; /* Reading UDR clears the RXC flag */
+
+	/* Store the byte only if there is a free place, otherwise drop it */
+	if((uint8)(g_rxHead - g_rxTail) < UART_RX_BUFFER_SIZE)
+	{
+		g_rxBuffer[g_rxHead & (UART_RX_BUFFER_SIZE - 1)] = data;
+		g_rxHead++;
+	}
+
+	if(g_rxCallBackPtr != NULL_PTR)
+	{
+		(*g_rxCallBackPtr)();
+	}
+}
+
+/* Interrupt Service Routine for UART Data Register Empty */
+ISR(USART_UDRE_vect)
+{
+	if(g_txHead != g_txTail)
+	{
+		SET_BIT(UCSRA,TXC); /* Writing one clears the TX complete flag of the previous byte */
+		UDR = g_txBuffer[g_txTail & (UART_TX_BUFFER_SIZE - 1)];
+		g_txTail++;
+		g_txStarted = True;
+	}
+	else
+	{
+		/* Nothing left to send, disable the interrupt until new data is queued */
+		CLEAR_BIT(UCSRB,UDRIE);
+	}
+}
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -22,17 +85,22 @@
  * Description:
  * Function responsible for initializing the UART device. It sets up the frame format
  * including the number of data bits, parity bit type, and number of stop bits.
- * It also enables the UART and sets the baud rate.
+ * It also enables the UART, the receive complete interrupt and sets the baud rate.
  */
 void UART_init(const UART_ConfigType * Config_Ptr)
 {
 	uint16 ubrr_value = 0;
 
+	/* Start with empty ring buffers */
+	g_rxHead = g_rxTail = 0;
+	g_txHead = g_txTail = 0;
+	g_txStarted = False;
+
 	/* U2X = 1 for double transmission speed */
 	UCSRA = (1<<U2X);
 
 	// Configure UCSRB register
-	UCSRB = (1<<RXEN) | (1<<TXEN); // Enable Receiver and Transmitter
+	UCSRB = (1<<RXCIE) | (1<<RXEN) | (1<<TXEN); // Enable Receiver, Transmitter and RX Complete Interrupt
 
 	// Configure UCSRC register
 	UCSRC = (1<<URSEL); // Set URSEL to write to UCSRC
@@ -51,28 +119,89 @@ void UART_init(const UART_ConfigType * Config_Ptr)
 	UBRRL = ubrr_value;
 }
 
+/*
+ * Description:
+ * Function responsible for queuing bytes for transmission.
+ * It copies as many bytes as fit in the TX ring buffer, enables the
+ * Data Register Empty interrupt and returns immediately with the copied count.
+ */
+uint8 UART_write(const uint8 *data, uint8 size)
+{
+	uint8 count = 0;
+
+	while((count < size) && ((uint8)(g_txHead - g_txTail) < UART_TX_BUFFER_SIZE))
+	{
+		g_txBuffer[g_txHead & (UART_TX_BUFFER_SIZE - 1)] = data[count];
+		g_txHead++;
+		count++;
+	}
+
+	if(count != 0)
+	{
+		SET_BIT(UCSRB,UDRIE); // The ISR will move the bytes to UDR
+	}
+
+	return count;
+}
+
+/*
+ * Description:
+ * Function responsible for taking received bytes out of the RX ring buffer.
+ * It copies at most size bytes and returns immediately with the copied count.
+ */
+uint8 UART_read(uint8 *data, uint8 size)
+{
+	uint8 count = 0;
+
+	while((count < size) && (g_rxHead != g_rxTail))
+	{
+		data[count] = g_rxBuffer[g_rxTail & (UART_RX_BUFFER_SIZE - 1)];
+		g_rxTail++;
+		count++;
+	}
+
+	return count;
+}
+
+/*
+ * Description:
+ * Function responsible for returning the number of bytes waiting in the RX ring buffer.
+ */
+uint8 UART_available(void)
+{
+	return (uint8)(g_rxHead - g_rxTail);
+}
+
+/*
+ * Description:
+ * Function responsible for checking that every queued byte has been shifted out.
+ */
+boolean UART_isTxComplete(void)
+{
+	return (g_txHead == g_txTail) && (!g_txStarted || BIT_IS_SET(UCSRA,TXC));
+}
+
 /*
  * Description:
  * Function responsible for sending a byte to another UART device.
- * It waits until the UART Data Register Empty (UDRE) flag is set and
- * then puts the data in the UDR register.
+ * It waits only while the TX ring buffer is full, the ISR puts the data in the UDR register.
  */
 void UART_sendByte(const uint8 data)
 {
-	while(BIT_IS_CLEAR(UCSRA,UDRE)){} // Wait until UDRE flag is set
-	UDR = data; // Put the data in UDR
+	while(UART_write(&data, 1) == 0){} // Wait until there is a free place in the TX buffer
 }
 
 /*
  * Description:
  * Function responsible for receiving a byte from another UART device.
- * It waits until the UART Receive Complete (RXC) flag is set and then
- * reads the data from the UDR register.
+ * It waits until the RX ring buffer holds a byte and then returns it.
  */
 uint8 UART_recieveByte(void)
 {
-	while(BIT_IS_CLEAR(UCSRA,RXC)){} // Wait until RXC flag is set
-	return UDR; // Read and return the received data from UDR
+	uint8 data;
+
+	while(UART_read(&data, 1) == 0){} // Wait until a byte is received by the ISR
+	return data; // Return the received data
 }
 
 /*
@@ -109,3 +238,12 @@ void UART_receiveString(uint8 *Str)
 
 	Str[i] = '\0'; // Terminate the string with null character
 }
+
+/*
+ * Description:
+ * Set the function called from the RX ISR after each received byte.
+ */
+void UART_setRxCallBack(void (*a_ptr)(void))
+{
+	g_rxCallBackPtr = a_ptr;
+}
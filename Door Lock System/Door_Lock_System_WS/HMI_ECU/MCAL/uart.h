@@ -14,6 +14,29 @@
 
 #include "../LIB/std_types.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Size of the receive and transmit ring buffers in bytes.
+ * Each size should be a power of two so the indices wrap with a simple mask.
+ */
+#define UART_RX_BUFFER_SIZE 32
+#define UART_TX_BUFFER_SIZE 32
+
+#if((UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) != 0) || (UART_RX_BUFFER_SIZE > 128)
+
+#error "UART RX buffer size should be a power of two and not more than 128"
+
+#endif
+
+#if((UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)) != 0) || (UART_TX_BUFFER_SIZE > 128)
+
+#error "UART TX buffer size should be a power of two and not more than 128"
+
+#endif
+
 // Enumeration for different configurations of UART data bits
 typedef enum{
 	FIVE_BITS,
@@ -53,15 +76,50 @@ typedef struct{
  */
 void UART_init(const UART_ConfigType * Config_Ptr);
 
+/*
+ * Description:
+ * Function to queue up to size bytes for transmission without waiting.
+ * Returns the number of bytes actually placed in the TX ring buffer.
+ */
+uint8 UART_write(const uint8 *data, uint8 size);
+
+/*
+ * Description:
+ * Function to take up to size received bytes out of the RX ring buffer without waiting.
+ * Returns the number of bytes actually copied to data.
+ */
+uint8 UART_read(uint8 *data, uint8 size);
+
+/*
+ * Description:
+ * Function to return the number of received bytes waiting in the RX ring buffer.
+ */
+uint8 UART_available(void);
+
+/*
+ * Description:
+ * Function to set a callback called from the RX ISR after each received byte.
+ * It runs in the interrupt context, it should only note that data is waiting.
+ */
+void UART_setRxCallBack(void (*a_ptr)(void));
+
+/*
+ * Description:
+ * Function to check if the TX ring buffer is empty and the last byte has left the shift register.
+ */
+boolean UART_isTxComplete(void);
+
 /*
  * Description:
  * Function to send a byte to another UART device.
+ * It blocks only while the TX ring buffer is full.
  */
 void UART_sendByte(const uint8 data);
 
 /*
  * Description:
  * Function to receive a byte from another UART device.
+ * It blocks until a byte is available in the RX ring buffer.
  */
 uint8 UART_recieveByte(void);
 
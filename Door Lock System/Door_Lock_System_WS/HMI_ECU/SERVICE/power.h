@@ -0,0 +1,79 @@
+ /******************************************************************************
+ *
+ * Module: Power
+ *
+ * File Name: power.h
+ *
+ * Description: Header file for the sleep modes and their residency counters
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define POWER_MODES 8
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * Sleep modes with their SM2:0 value. Deeper modes stop more clocks and wake on less sources:
+ * IDLE keeps the timers, the UART and the TWI running, POWER_DOWN only wakes on an external
+ * interrupt (low level on INT0/INT1, edge on INT2), a TWI address match or the watchdog.
+ */
+typedef enum{
+	POWER_IDLE,
+	POWER_ADC_NOISE_REDUCTION,
+	POWER_DOWN,
+	POWER_SAVE,
+	POWER_STANDBY = 6,
+	POWER_EXTENDED_STANDBY
+}Power_ModeType;
+
+/* Residency of one mode since Power_init */
+typedef struct{
+	uint32 sleeps; /* Number of times the mode was entered */
+	uint32 time_ms; /* Time spent in the mode, measured on the time source */
+}Power_ResidencyType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the residency counters.
+ */
+void Power_init(void);
+
+/*
+ * Description :
+ * Set the clock used to measure the time spent sleeping, like SwTimer_getMs.
+ * The time in a mode stopping the clock of that source is not counted, only the sleeps.
+ */
+void Power_setTimeSource(uint32 (*time_source)(void));
+
+/*
+ * Description :
+ * Sleep in mode until an interrupt wakes the MCU, the ISR has run when it returns.
+ * Call it with the interrupts disabled once nothing is left to do, so an interrupt raised
+ * after that check still wakes the sleep at once. The interrupts are enabled on return.
+ */
+void Power_sleep(Power_ModeType mode);
+
+/*
+ * Description :
+ * Copy the residency counters of mode.
+ */
+void Power_getResidency(Power_ModeType mode, Power_ResidencyType *residency);
+
+#endif /* POWER_H_ */
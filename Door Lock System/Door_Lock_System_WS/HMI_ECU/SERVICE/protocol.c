@@ -0,0 +1,249 @@
+ /******************************************************************************
+ *
+ * Module: Protocol
+ *
+ * File Name: protocol.c
+ *
+ * Description: Source file for the framed command protocol between the HMI ECU
+ *              and the Control ECU
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "protocol.h"
+#include "../MCAL/uart.h"
+#include "../LIB/crc16.h"
+#include "sw_timer.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	WAIT_SOF,
+	WAIT_OPCODE,
+	WAIT_LENGTH,
+	WAIT_SEQUENCE,
+	WAIT_PAYLOAD,
+	WAIT_CRC_HIGH,
+	WAIT_CRC_LOW
+}Protocol_ParserState;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static Protocol_ParserState g_parserState = WAIT_SOF;
+static Protocol_FrameType g_rxFrame; /* Frame under construction */
+static uint8 g_rxIndex = 0; /* Next payload byte to receive */
+static uint16 g_rxCrc = 0; /* CRC received from the wire */
+static uint8 g_txSequence = 0; /* Sequence number of the last sent request */
+static uint32 g_rxTime = 0; /* When the parser took its last byte */
+
+/* Last reply sent, kept to answer a retry of its request without serving it again */
+static Protocol_FrameType g_lastReply;
+static uint16 g_lastRequestCrc; /* CRC of the request, it covers its sequence */
+static uint32 g_lastReplyTime;
+static boolean g_lastReplyValid = False;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void Protocol_transmit(uint8 opcode, uint8 sequence, const uint8 *payload, uint8 length);
+static uint16 Protocol_frameCrc(const Protocol_FrameType *frame);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void Protocol_init(void)
+{
+	g_parserState = WAIT_SOF;
+	g_txSequence = 0;
+	g_lastReplyValid = False;
+}
+
+uint8 Protocol_sendFrame(uint8 opcode, const uint8 *payload, uint8 length)
+{
+	g_txSequence++;
+	Protocol_transmit(opcode, g_txSequence, payload, length);
+	return g_txSequence;
+}
+
+void Protocol_resendFrame(uint8 opcode, uint8 sequence, const uint8 *payload, uint8 length)
+{
+	Protocol_transmit(opcode, sequence, payload, length);
+}
+
+void Protocol_sendReply(const Protocol_FrameType *request, uint8 opcode, const uint8 *payload, uint8 length)
+{
+	uint8 i;
+
+	Protocol_transmit(opcode, request->sequence, payload, length);
+
+	/* A FRAME_NACK means the request was not served, its retry is served */
+	if(opcode == FRAME_NACK)
+	{
+		return;
+	}
+	if(length > PROTOCOL_MAX_PAYLOAD)
+	{
+		length = PROTOCOL_MAX_PAYLOAD;
+	}
+	g_lastReply.opcode = opcode;
+	g_lastReply.length = length;
+	g_lastReply.sequence = request->sequence;
+	for(i = 0; i < length; i++)
+	{
+		g_lastReply.payload[i] = payload[i];
+	}
+	g_lastRequestCrc = Protocol_frameCrc(request);
+	g_lastReplyTime = SwTimer_getMs();
+	g_lastReplyValid = True;
+}
+
+boolean Protocol_resendReply(const Protocol_FrameType *request)
+{
+	/*
+	 * Same sequence and same content within the retries of the requester. The time limit
+	 * keeps a requester that restarted its sequence numbers from getting an old reply.
+	 */
+	if(!g_lastReplyValid || (request->sequence != g_lastReply.sequence) ||
+			(Protocol_frameCrc(request) != g_lastRequestCrc) ||
+			SwTimer_isReached(g_lastReplyTime + PROTOCOL_REPLY_CACHE_MS))
+	{
+		return False;
+	}
+
+	Protocol_transmit(g_lastReply.opcode, g_lastReply.sequence, g_lastReply.payload, g_lastReply.length);
+	return True;
+}
+
+Protocol_StatusType Protocol_poll(Protocol_FrameType *frame)
+{
+	uint8 data;
+	uint8 i;
+
+	while(UART_read(&data, 1) != 0)
+	{
+		/* The rest of a frame cut too long ago is lost, this byte may start the next one */
+		if((g_parserState != WAIT_SOF) && SwTimer_isReached(g_rxTime + PROTOCOL_BYTE_TIMEOUT_MS))
+		{
+			g_parserState = WAIT_SOF;
+		}
+		g_rxTime = SwTimer_getMs();
+
+		switch(g_parserState)
+		{
+		case WAIT_SOF:
+			if(data == PROTOCOL_SOF)
+			{
+				g_parserState = WAIT_OPCODE;
+			}
+			break;
+		case WAIT_OPCODE:
+			g_rxFrame.opcode = data;
+			g_parserState = WAIT_LENGTH;
+			break;
+		case WAIT_LENGTH:
+			if(data > PROTOCOL_MAX_PAYLOAD)
+			{
+				/* Can not be a valid frame, drop it and search for the next SOF */
+				g_parserState = WAIT_SOF;
+				frame->sequence = 0; /* Not received yet, the requester takes a FRAME_NACK of any sequence */
+				return PROTOCOL_FRAME_ERROR;
+			}
+			g_rxFrame.length = data;
+			g_parserState = WAIT_SEQUENCE;
+			break;
+		case WAIT_SEQUENCE:
+			g_rxFrame.sequence = data;
+			g_rxIndex = 0;
+			g_parserState = (g_rxFrame.length != 0) ? WAIT_PAYLOAD : WAIT_CRC_HIGH;
+			break;
+		case WAIT_PAYLOAD:
+			g_rxFrame.payload[g_rxIndex++] = data;
+			if(g_rxIndex == g_rxFrame.length)
+			{
+				g_parserState = WAIT_CRC_HIGH;
+			}
+			break;
+		case WAIT_CRC_HIGH:
+			g_rxCrc = (uint16)data << 8;
+			g_parserState = WAIT_CRC_LOW;
+			break;
+		case WAIT_CRC_LOW:
+			g_rxCrc |= data;
+			g_parserState = WAIT_SOF;
+			frame->sequence = g_rxFrame.sequence; /* Best effort, lets the reply carry the same sequence */
+			if(g_rxCrc != Protocol_frameCrc(&g_rxFrame))
+			{
+				return PROTOCOL_FRAME_ERROR;
+			}
+			frame->opcode = g_rxFrame.opcode;
+			frame->length = g_rxFrame.length;
+			for(i = 0; i < g_rxFrame.length; i++)
+			{
+				frame->payload[i] = g_rxFrame.payload[i];
+			}
+			return PROTOCOL_FRAME_OK;
+		}
+	}
+
+	return PROTOCOL_NO_FRAME;
+}
+
+/*
+ * Description :
+ * Build the frame and hand it to the UART driver in one burst.
+ */
+static void Protocol_transmit(uint8 opcode, uint8 sequence, const uint8 *payload, uint8 length)
+{
+	uint8 buffer[PROTOCOL_HEADER_SIZE + PROTOCOL_MAX_PAYLOAD + PROTOCOL_CRC_SIZE];
+	uint8 size = 0;
+	uint8 sent = 0;
+	uint16 crc;
+	uint8 i;
+
+	if(length > PROTOCOL_MAX_PAYLOAD)
+	{
+		length = PROTOCOL_MAX_PAYLOAD;
+	}
+
+	buffer[size++] = PROTOCOL_SOF;
+	buffer[size++] = opcode;
+	buffer[size++] = length;
+	buffer[size++] = sequence;
+	for(i = 0; i < length; i++)
+	{
+		buffer[size++] = payload[i];
+	}
+
+	/* CRC starts after the SOF byte */
+	crc = CRC16_update(CRC16_INITIAL_VALUE, &buffer[1], size - 1);
+	buffer[size++] = (uint8)(crc >> 8);
+	buffer[size++] = (uint8)crc;
+
+	/* Blocks only if the frame does not fit in the free part of the TX buffer */
+	while(sent < size)
+	{
+		sent += UART_write(&buffer[sent], size - sent);
+	}
+}
+
+/*
+ * Description :
+ * Calculate the CRC of a received frame the same way the transmitter did.
+ */
+static uint16 Protocol_frameCrc(const Protocol_FrameType *frame)
+{
+	uint8 header[PROTOCOL_HEADER_SIZE - 1];
+
+	header[0] = frame->opcode;
+	header[1] = frame->length;
+	header[2] = frame->sequence;
+
+	return CRC16_update(CRC16_update(CRC16_INITIAL_VALUE, header, sizeof(header)), frame->payload, frame->length);
+}
@@ -0,0 +1,146 @@
+ /******************************************************************************
+ *
+ * Module: Protocol
+ *
+ * File Name: protocol.h
+ *
+ * Description: Header file for the framed command protocol between the HMI ECU
+ *              and the Control ECU
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef PROTOCOL_H_
+#define PROTOCOL_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Frame layout on the wire:
+ * | SOF | OPCODE | LENGTH | SEQUENCE | PAYLOAD[LENGTH] | CRC16 High | CRC16 Low |
+ * The CRC covers the opcode, length, sequence and payload bytes.
+ */
+#define PROTOCOL_SOF                 0x7E
+#define PROTOCOL_MAX_PAYLOAD         16
+#define PROTOCOL_HEADER_SIZE         4
+#define PROTOCOL_CRC_SIZE            2
+
+/* Number of times a request is sent again after a corrupted, rejected or missing reply */
+#define PROTOCOL_MAX_RETRIES         3
+
+/*
+ * Time given to the other ECU to reply, it covers a 22 bytes frame each way at 9600 baud
+ * and the EEPROM writes of a request. A longer gap between two bytes drops the frame.
+ */
+#define PROTOCOL_REPLY_TIMEOUT_MS    300
+#define PROTOCOL_BYTE_TIMEOUT_MS     50
+
+/* The last reply is sent again for a retry of its request coming within this time */
+#define PROTOCOL_REPLY_CACHE_MS      (PROTOCOL_REPLY_TIMEOUT_MS * (PROTOCOL_MAX_RETRIES + 1))
+
+/* Command opcodes */
+#define IS_PASSWORD_SETTED 'Q'              // Indicates if password is already set
+#define SETTED 'W'                          // Indicates password is already set in EEPROM
+#define NOT_SETTED 'E'                      // Indicates password is not set in EEPROM yet, also the reply to a password check then
+#define GET_READY_FOR_PASSWORD 'R'          // Password to be checked, sent in the payload
+#define CORRECT_PASSWORD 'T'                // Indicates correct password
+#define NOT_CORRECT_PASSWORD 'Y'            // Indicates incorrect password
+#define OPEN_DOOR 'U'                       // Command to open the door
+#define ERROR_ACTION 'I'                    // Action taken when an error occurs
+#define GET_READY_FOR_PASSWORD_ONE 'O'      // First password for setup, sent in the payload
+#define GET_READY_FOR_PASSWORD_TWO 'P'      // Second password for setup, sent in the payload
+#define IS_MATCHED 'A'                      // Request to check if the two entered passwords matched
+#define MATCHED 'S'                         // Indicates that two entered passwords matched
+#define NOT_MATCHED 'D'                     // Indicates that two entered passwords did not match
+#define FRAME_ACK 'F'                       // Request accepted, no other data to reply with
+#define FRAME_NACK 'G'                      // Request frame was corrupted or malformed, send it again
+#define GET_READY_FOR_MASTER_PASSWORD 'Z'   // Password to be checked before changing it, user PINs are not accepted
+#define USER_ADD 'H'                        // Add a user: master password, user id and PIN in the payload
+#define USER_REMOVE 'J'                     // Remove a user: master password and user id in the payload
+#define USER_ENABLE 'K'                     // Enable or disable a user: master password, user id and 1 or 0 in the payload
+#define USER_REFUSED 'L'                    // User command refused: wrong master password, unknown id or PIN in use
+#define GET_STATUS 'X'                      // Request the state of the door and of the alarm
+#define STATUS 'C'                          // Reply to GET_STATUS: door state, alarm on (1) or off (0) and seconds left of the door step
+#define SET_STALL 'V'                       // Motor stall settings: master password, threshold (high, low byte) and averaging window in the payload
+#define PLAY_SOUND 'B'                      // Buzzer pattern to play in the payload, only PLAY_SOUND_CHIRP, not replied so the HMI does not wait for it
+#define PLAY_SOUND_CHIRP 0                  // PLAY_SOUND payload for a key press, SOUND_CHIRP of the Control ECU
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct{
+	uint8 opcode; // Command or reply code
+	uint8 length; // Number of valid bytes in the payload
+	uint8 sequence; // Request number, echoed back in the reply
+	uint8 payload[PROTOCOL_MAX_PAYLOAD];
+}Protocol_FrameType;
+
+/* Steps of the door cycle, sent in the STATUS reply */
+typedef enum{
+	DOOR_CLOSED,
+	DOOR_UNLOCKING,
+	DOOR_HOLDING,
+	DOOR_LOCKING
+}Protocol_DoorStateType;
+
+typedef enum{
+	PROTOCOL_NO_FRAME, // No complete frame yet
+	PROTOCOL_FRAME_OK, // A valid frame has been received
+	PROTOCOL_FRAME_ERROR // A frame has been received with a wrong CRC or length
+}Protocol_StatusType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Reset the frame parser and the sequence counter. UART should be initialized before.
+ */
+void Protocol_init(void);
+
+/*
+ * Description :
+ * Send a new frame with the next sequence number in one burst.
+ * Returns the sequence number used for the frame.
+ */
+uint8 Protocol_sendFrame(uint8 opcode, const uint8 *payload, uint8 length);
+
+/*
+ * Description :
+ * Send a frame again with the sequence number it was first sent with, so the other ECU
+ * can tell the retry of a request whose reply was lost.
+ */
+void Protocol_resendFrame(uint8 opcode, uint8 sequence, const uint8 *payload, uint8 length);
+
+/*
+ * Description :
+ * Send a reply frame carrying the same sequence number as the request.
+ * The reply is kept for Protocol_resendReply, except a FRAME_NACK.
+ */
+void Protocol_sendReply(const Protocol_FrameType *request, uint8 opcode, const uint8 *payload, uint8 length);
+
+/*
+ * Description :
+ * If request is a retry of the last request replied to, with the same sequence and content
+ * within PROTOCOL_REPLY_CACHE_MS, send the kept reply again and return True. The request
+ * should not be served again then, its reply was lost and not the command.
+ * Returns False for a new request.
+ */
+boolean Protocol_resendReply(const Protocol_FrameType *request);
+
+/*
+ * Description :
+ * Feed the frame parser with the bytes waiting in the UART RX buffer without blocking.
+ * When a complete frame is found it is copied to frame.
+ * A frame with more than PROTOCOL_BYTE_TIMEOUT_MS between two bytes is dropped.
+ */
+Protocol_StatusType Protocol_poll(Protocol_FrameType *frame);
+
+#endif /* PROTOCOL_H_ */
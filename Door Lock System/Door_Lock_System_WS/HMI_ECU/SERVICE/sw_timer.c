@@ -0,0 +1,174 @@
+ /******************************************************************************
+ *
+ * Module: Software Timer
+ *
+ * File Name: sw_timer.c
+ *
+ * Description: Source file for the millisecond system tick and the software
+ *              timers running on top of Timer1
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#include "sw_timer.h"
+#include "../MCAL/timer1.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile uint32 g_ms = 0;
+
+/* Running timers, the first one expires first. Changed by the tick ISR */
+static SwTimer_Type *volatile g_list = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void SwTimer_tick(void);
+static void SwTimer_insert(SwTimer_Type *timer);
+static void SwTimer_remove(SwTimer_Type *timer);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+void SwTimer_init(void)
+{
+	Timer1_ConfigType Timer1_config = {
+			.initial_value = 0,
+			.compare_value = SW_TIMER_COMPARE_VALUE,
+			.mode = COMPARE,
+			.prescaler = PRESCALER_64
+	};
+
+	Timer1_setCallBack(SwTimer_tick);
+	Timer1_init(&Timer1_config);
+}
+
+uint32 SwTimer_getMs(void)
+{
+	uint32 ms;
+	uint8 sreg;
+
+	/* Four bytes changed by the ISR, read them together */
+	sreg = SREG;
+	cli();
+	ms = g_ms;
+	SREG = sreg;
+
+	return ms;
+}
+
+boolean SwTimer_isReached(uint32 timestamp)
+{
+	return (sint32)(SwTimer_getMs() - timestamp) >= 0;
+}
+
+void SwTimer_start(SwTimer_Type *timer, uint32 delay_ms, uint32 period_ms, void (*callback)(void))
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if(timer->running)
+	{
+		SwTimer_remove(timer);
+	}
+
+	timer->expiry = g_ms + delay_ms;
+	timer->period = period_ms;
+	timer->callback = callback;
+	SwTimer_insert(timer);
+
+	SREG = sreg;
+}
+
+void SwTimer_stop(SwTimer_Type *timer)
+{
+	uint8 sreg;
+
+	sreg = SREG;
+	cli();
+
+	if(timer->running)
+	{
+		SwTimer_remove(timer);
+	}
+
+	SREG = sreg;
+}
+
+boolean SwTimer_isRunning(const SwTimer_Type *timer)
+{
+	return timer->running;
+}
+
+/*
+ * Description :
+ * Timer1 compare callback, once per millisecond. Only the head of the list is checked,
+ * the other timers expire later.
+ */
+static void SwTimer_tick(void)
+{
+	SwTimer_Type *timer;
+
+	g_ms++;
+
+	while((g_list != NULL_PTR) && ((sint32)(g_ms - g_list->expiry) >= 0))
+	{
+		timer = g_list;
+		g_list = timer->next;
+		timer->running = False;
+
+		/* Periodic timers keep their phase, the next expiry does not drift with the callback */
+		if(timer->period != 0)
+		{
+			timer->expiry += timer->period;
+			SwTimer_insert(timer);
+		}
+
+		(*timer->callback)();
+	}
+}
+
+/*
+ * Description :
+ * Link the timer after the ones that expire before or at the same time.
+ * Called with the interrupts disabled.
+ */
+static void SwTimer_insert(SwTimer_Type *timer)
+{
+	SwTimer_Type **link = (SwTimer_Type **)&g_list;
+
+	while((*link != NULL_PTR) && ((sint32)(timer->expiry - (*link)->expiry) >= 0))
+	{
+		link = &(*link)->next;
+	}
+
+	timer->next = *link;
+	*link = timer;
+	timer->running = True;
+}
+
+/*
+ * Description :
+ * Unlink a running timer. Called with the interrupts disabled.
+ */
+static void SwTimer_remove(SwTimer_Type *timer)
+{
+	SwTimer_Type **link = (SwTimer_Type **)&g_list;
+
+	while(*link != timer)
+	{
+		link = &(*link)->next;
+	}
+
+	*link = timer->next;
+	timer->running = False;
+}
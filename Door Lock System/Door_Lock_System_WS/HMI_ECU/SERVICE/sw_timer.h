@@ -0,0 +1,84 @@
+ /******************************************************************************
+ *
+ * Module: Software Timer
+ *
+ * File Name: sw_timer.h
+ *
+ * Description: Header file for the millisecond system tick and the software
+ *              timers running on top of Timer1
+ *
+ * Author: Diaa Ahmed
+ *
+ *******************************************************************************/
+
+#ifndef SW_TIMER_H_
+#define SW_TIMER_H_
+
+#include "../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Timer1 runs free in compare mode, F_CPU / 64 / (SW_TIMER_COMPARE_VALUE + 1) = 1 kHz */
+#define SW_TIMER_COMPARE_VALUE ((uint16)((F_CPU / 64UL / 1000UL) - 1))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * One software timer, owned by the caller and linked in the list of running timers
+ * sorted by expiry time. Its fields are only changed through the functions below.
+ */
+typedef struct SwTimer{
+	uint32 expiry; /* Tick count at which the callback is called */
+	uint32 period; /* Milliseconds between two calls, 0 for a one-shot timer */
+	void (*callback)(void);
+	struct SwTimer *next;
+	boolean running;
+}SwTimer_Type;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start Timer1 as the free running 1 ms tick. Timer1 is not used by anything else after that.
+ */
+void SwTimer_init(void);
+
+/*
+ * Description :
+ * Returns the milliseconds since SwTimer_init, it wraps after about 49 days.
+ */
+uint32 SwTimer_getMs(void);
+
+/*
+ * Description :
+ * Returns True once the tick reached the timestamp, a value taken from SwTimer_getMs
+ * plus a delay. Works across the wrap of the tick for delays under 24 days.
+ */
+boolean SwTimer_isReached(uint32 timestamp);
+
+/*
+ * Description :
+ * (Re)start timer to call callback after delay_ms, then every period_ms if it is not 0.
+ * The callback is called from the tick ISR, it should be short and may start or stop timers.
+ */
+void SwTimer_start(SwTimer_Type *timer, uint32 delay_ms, uint32 period_ms, void (*callback)(void));
+
+/*
+ * Description :
+ * Stop timer, nothing happens if it is not running.
+ */
+void SwTimer_stop(SwTimer_Type *timer);
+
+/*
+ * Description :
+ * Returns True while timer waits for its next call.
+ */
+boolean SwTimer_isRunning(const SwTimer_Type *timer);
+
+#endif /* SW_TIMER_H_ */